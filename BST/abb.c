@@ -1,7 +1,98 @@
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "abb.h"
+#include "abb_interno.h"
+#include "pool_nodos.h"
+
+#define ARCHIVO_FIRMA          "ABB1"      // Identifica los archivos guardados por arbol_guardar
+#define ARCHIVO_MULTICONJUNTO  1           // Bandera de la cabecera: se guardan repeticiones
+#define ARCHIVO_TAMANIO_BUFFER (1 << 20)   // Buffer de lectura y escritura de los archivos
+#define ARCHIVO_CAPACIDAD      1024        // Elementos que se reservan al empezar a cargar un arbol
+#define AGREGADO_EN_PILA       128         // Agregados de hasta este tamaño se calculan en la pila
+
+/*
+ * Elemento a comparar contra los nodos del arbol, junto con su prefijo,
+ * que se calcula una sola vez por operacion.
+ */
+typedef struct clave
+{
+    void*    elemento;
+    uint64_t prefijo;
+} clave_t;
+
+/*
+ * Devuelve la posicion del prefijo dentro de los campos opcionales del
+ * nodo, despues de las repeticiones si el arbol es multiconjunto.
+ */
+static size_t desplazamiento_prefijo(abb_t* arbol)
+{
+    return arbol->multiconjunto ? sizeof(size_t) : 0;
+}
+
+/*
+ * Devuelve la posicion del agregado dentro de los campos opcionales del
+ * nodo, despues del prefijo y alineada para cualquier tipo.
+ */
+static size_t desplazamiento_agregado(abb_t* arbol)
+{
+    size_t desplazamiento = desplazamiento_prefijo(arbol) + (arbol->prefijo ? sizeof(uint64_t) : 0);
+    size_t alineacion = _Alignof(max_align_t);
+    return (desplazamiento + alineacion - 1) / alineacion * alineacion;
+}
+
+/*
+ * Devuelve el tamaño en bytes de los nodos del arbol, que solo incluye
+ * los campos opcionales que usa su configuracion.
+ */
+static size_t tamanio_nodo(abb_t* arbol)
+{
+    if (arbol->agregado.tamanio)
+        return sizeof(nodo_abb_t) + desplazamiento_agregado(arbol) + arbol->agregado.tamanio;
+    return sizeof(nodo_abb_t) + desplazamiento_prefijo(arbol) +
+           (arbol->prefijo ? sizeof(uint64_t) : 0);
+}
+
+/*
+ * Cambia las repeticiones del elemento del nodo. Fuera del modo
+ * multiconjunto son siempre 1 y no se guardan.
+ */
+static void fijar_repeticiones(abb_t* arbol, nodo_abb_t* nodo, size_t repeticiones)
+{
+    if (arbol->multiconjunto)
+        memcpy(nodo->opcionales, &repeticiones, sizeof(repeticiones));
+}
+
+/*
+ * Devuelve el prefijo guardado en el nodo. Solo si el arbol usa prefijos.
+ */
+static uint64_t prefijo_de(abb_t* arbol, nodo_abb_t* nodo)
+{
+    uint64_t prefijo;
+    memcpy(&prefijo, (char*)nodo->opcionales + desplazamiento_prefijo(arbol), sizeof(prefijo));
+    return prefijo;
+}
+
+/*
+ * Guarda el prefijo en el nodo, si el arbol usa prefijos.
+ */
+static void fijar_prefijo(abb_t* arbol, nodo_abb_t* nodo, uint64_t prefijo)
+{
+    if (arbol->prefijo)
+        memcpy((char*)nodo->opcionales + desplazamiento_prefijo(arbol), &prefijo, sizeof(prefijo));
+}
+
+/*
+ * Devuelve el agregado del subarbol guardado en el nodo. Solo si el
+ * arbol tiene un agregado definido.
+ */
+static void* agregado_de(abb_t* arbol, nodo_abb_t* nodo)
+{
+    return (char*)nodo->opcionales + desplazamiento_agregado(arbol);
+}
 
 /*
  * Crea el arbol y reserva la memoria necesaria de la estructura.
@@ -18,52 +109,140 @@ abb_t* arbol_crear(abb_comparador comparador, abb_liberar_elemento destructor)
     abb_t* arbol = calloc(1, sizeof(abb_t));
     if (!arbol)
         return NULL;
+    arbol->pool = pool_crear(tamanio_nodo(arbol));
+    if (!arbol->pool)
+    {
+        free(arbol);
+        return NULL;
+    }
     arbol->comparador = comparador;
     arbol->destructor = destructor;
     return arbol;
 }
 
 /*
- * Crea un nuevo nodo y le asigna el elemento que guarda,
- * asi como NULL a ambas ramas.
+ * Recalcula el tamaño del subarbol y, si el arbol tiene un agregado
+ * definido, el agregado del subarbol, a partir de los de sus hijos.
+ * Debe llamarse cada vez que cambia alguna de las ramas del nodo o sus
+ * repeticiones.
+ */
+static void actualizar(abb_t* arbol, nodo_abb_t* nodo)
+{
+    size_t repeticiones = repeticiones_de(arbol, nodo);
+    nodo->tamanio = repeticiones + tamanio(nodo->izquierda) + tamanio(nodo->derecha);
+    abb_agregado_t* agregado = &arbol->agregado;
+    if (!agregado->tamanio)
+        return;
+    // Se combina en orden: rama izquierda, nodo, rama derecha
+    void* valor = agregado_de(arbol, nodo);
+    agregado->extraer(nodo->elemento, repeticiones, valor);
+    if (nodo->izquierda)
+        agregado->combinar(agregado_de(arbol, nodo->izquierda), valor, valor);
+    if (nodo->derecha)
+        agregado->combinar(valor, agregado_de(arbol, nodo->derecha), valor);
+}
+
+/*
+ * Devuelve el prefijo del elemento, o 0 si el arbol no usa prefijos.
+ */
+static uint64_t calcular_prefijo(abb_t* arbol, void* elemento)
+{
+    if (!arbol->prefijo)
+        return 0;
+    return arbol->prefijo(elemento);
+}
+
+/*
+ * Arma la clave del elemento para compararlo contra los nodos del arbol.
+ */
+static clave_t crear_clave(abb_t* arbol, void* elemento)
+{
+    clave_t clave = {elemento, calcular_prefijo(arbol, elemento)};
+    return clave;
+}
+
+/*
+ * Compara la clave contra el elemento del nodo. Los prefijos distintos
+ * deciden el orden sin llamar al comparador (si el arbol no usa
+ * prefijos, siempre se llama al comparador).
+ *
+ * Devuelve lo mismo que el comparador.
+ */
+static int comparar(abb_t* arbol, clave_t* clave, nodo_abb_t* nodo)
+{
+    if (arbol->prefijo)
+    {
+        uint64_t prefijo = prefijo_de(arbol, nodo);
+        if (clave->prefijo != prefijo)
+            return clave->prefijo < prefijo ? -1 : 1;
+    }
+    return arbol->comparador(clave->elemento, nodo->elemento);
+}
+
+/*
+ * Crea un nuevo nodo desde el pool del arbol y le asigna el elemento
+ * que guarda, asi como NULL a ambas ramas.
  *
  * Devuelve NULL en caso de no poder crear.
  */
-static nodo_abb_t* nuevo_nodo(void* elemento)
+static nodo_abb_t* nuevo_nodo(abb_t* arbol, clave_t* clave)
 {
-    nodo_abb_t* nodo = calloc(1, sizeof(nodo_abb_t));
+    nodo_abb_t* nodo = pool_reservar(arbol->pool);
     if (!nodo)
         return NULL;
-    nodo->elemento = elemento;
+    nodo->elemento = clave->elemento;
+    fijar_prefijo(arbol, nodo, clave->prefijo);
+    fijar_repeticiones(arbol, nodo, 1);
+    actualizar(arbol, nodo);
     return nodo;
 }
 
+/*
+ * Utiliza el destructor en caso de existir.
+ */
+static void destruir_elemento(void* elemento, abb_liberar_elemento destructor)
+{
+    if (destructor)
+        destructor(elemento);
+}
+
 /*
  * Inserta un nodo recursivamente.
- * Recibe un nodo,
- * un puntero a un comparador,
- * el elemento a insertar
+ * Recibe el arbol (del que se usan el comparador y el pool),
+ * un nodo,
+ * la clave del elemento a insertar
  *
- * La funcion deja de llamarse recursivamente cuando el nodo sea NULL.
+ * La funcion deja de llamarse recursivamente cuando el nodo sea NULL, o
+ * en modo multiconjunto cuando encuentra un nodo igual al elemento, en
+ * cuyo caso suma una repeticion y el elemento se destruye, salvo que sea
+ * el mismo puntero que el conservado.
  *
  * Devuelve un arbol con el elemento insertado en el lugar que corresponde.
  * Devuelve NULL en caso de fallar al crear el nodo.
  */
-static nodo_abb_t* insertar(nodo_abb_t* nodo, abb_comparador comparador, void* elemento)
+static nodo_abb_t* insertar(abb_t* arbol, nodo_abb_t* nodo, clave_t* clave)
 {
+    abb_comparador comparador = arbol->comparador;
     if (!comparador) // Sin comparador, no entra a llamarse a si misma.
         return NULL;
     if (!nodo) // Nodo NULL, estoy en donde deberia ir el nodo
     {
-        nodo_abb_t* n_nodo = nuevo_nodo(elemento);
+        nodo_abb_t* n_nodo = nuevo_nodo(arbol, clave);
         if (n_nodo)
             return n_nodo;
         return NULL;
     }
+    int comparacion = comparar(arbol, clave, nodo);
+    if (arbol->multiconjunto && comparacion == 0)
+    {
+        fijar_repeticiones(arbol, nodo, repeticiones_de(arbol, nodo) + 1);
+        if (clave->elemento != nodo->elemento)
+            destruir_elemento(clave->elemento, arbol->destructor);
+    }
     // El elemento a insertar es menor al que estoy ahora. Evaluo la rama izquierda del nodo actual.
-    if (comparador(elemento, nodo->elemento) == -1)
+    else if (comparacion == -1)
     {
-        nodo_abb_t* aux = insertar(nodo->izquierda, comparador, elemento);
+        nodo_abb_t* aux = insertar(arbol, nodo->izquierda, clave);
         if (!aux)
             return NULL;
         else
@@ -73,12 +252,13 @@ static nodo_abb_t* insertar(nodo_abb_t* nodo, abb_comparador comparador, void* e
     // actual
     else
     {
-        nodo_abb_t* aux = insertar(nodo->derecha, comparador, elemento);
+        nodo_abb_t* aux = insertar(arbol, nodo->derecha, clave);
         if (!aux)
             return NULL;
         else
             nodo->derecha = aux;
     }
+    actualizar(arbol, nodo);
     return nodo;
 }
 
@@ -91,7 +271,8 @@ int arbol_insertar(abb_t* arbol, void* elemento)
 {
     if (!arbol)
         return -1;
-    nodo_abb_t* auxiliar = insertar(arbol->nodo_raiz, arbol->comparador, elemento);
+    clave_t     clave = crear_clave(arbol, elemento);
+    nodo_abb_t* auxiliar = insertar(arbol, arbol->nodo_raiz, &clave);
     if (!auxiliar)
         return -1;
     arbol->nodo_raiz = auxiliar;
@@ -99,47 +280,259 @@ int arbol_insertar(abb_t* arbol, void* elemento)
 }
 
 /*
- * Utiliza el destructor en caso de existir.
+ * Devuelve true si el vector esta ordenado de menor a mayor segun el comparador.
  */
-static void destruir_elemento(void* elemento, abb_liberar_elemento destructor)
+static bool esta_ordenado(abb_comparador comparador, void** elementos, size_t cantidad)
 {
-    if (destructor)
-        destructor(elemento);
+    for (size_t i = 1; i < cantidad; i++)
+        if (comparador(elementos[i - 1], elementos[i]) > 0)
+            return false;
+    return true;
+}
+
+/*
+ * Construye recursivamente un arbol balanceado con los elementos del vector
+ * en el rango [inicio, fin), tomando como raiz el elemento del medio.
+ * Si repeticiones no es NULL, indica las repeticiones de cada elemento.
+ * Los nodos se reservan del pool dado, que puede no ser el del arbol.
+ *
+ * Devuelve la raiz del subarbol construido, NULL si el rango esta vacio.
+ * En caso de error de memoria se cambia la bandera de error.
+ */
+static nodo_abb_t* construir_balanceado(abb_t* arbol, struct pool_nodos* pool,
+                                        void** elementos, size_t* repeticiones, size_t inicio,
+                                        size_t fin, bool* error)
+{
+    if (inicio >= fin || *error)
+        return NULL;
+    size_t      medio = inicio + (fin - inicio) / 2;
+    nodo_abb_t* nodo = pool_reservar(pool);
+    if (!nodo)
+    {
+        *error = true;
+        return NULL;
+    }
+    nodo->elemento = elementos[medio];
+    fijar_prefijo(arbol, nodo, calcular_prefijo(arbol, elementos[medio]));
+    fijar_repeticiones(arbol, nodo, repeticiones ? repeticiones[medio] : 1);
+    nodo->izquierda =
+        construir_balanceado(arbol, pool, elementos, repeticiones, inicio, medio, error);
+    nodo->derecha =
+        construir_balanceado(arbol, pool, elementos, repeticiones, medio + 1, fin, error);
+    actualizar(arbol, nodo);
+    return nodo;
+}
+
+/*
+ * Crea un arbol balanceado a partir de un vector de elementos ordenado
+ * de menor a mayor segun el comparador, en tiempo lineal.
+ * Comparador y destructor cumplen la misma funcion que en arbol_crear.
+ *
+ * Devuelve un puntero al arbol creado o NULL en caso de error o si el
+ * vector no esta ordenado. En caso de error los elementos no se
+ * destruyen.
+ */
+abb_t* arbol_crear_desde_ordenado(abb_comparador comparador, abb_liberar_elemento destructor,
+                                  void** elementos, size_t cantidad)
+{
+    if (!comparador || (!elementos && cantidad))
+        return NULL;
+    if (!esta_ordenado(comparador, elementos, cantidad))
+        return NULL;
+    abb_t* arbol = arbol_crear(comparador, destructor);
+    if (!arbol)
+        return NULL;
+    bool error = false;
+    arbol->nodo_raiz =
+        construir_balanceado(arbol, arbol->pool, elementos, NULL, 0, cantidad, &error);
+    if (error)
+    {
+        // Los elementos siguen siendo del llamador, no se usa el destructor
+        arbol->destructor = NULL;
+        arbol_destruir(arbol);
+        return NULL;
+    }
+    return arbol;
+}
+
+/*
+ * Guarda en los vectores los elementos de cada nodo del subarbol, y sus
+ * repeticiones, en secuencia inorden.
+ */
+static void aplanar(abb_t* arbol, nodo_abb_t* nodo, void** elementos, size_t* repeticiones,
+                    size_t* contador)
+{
+    if (!nodo)
+        return;
+    aplanar(arbol, nodo->izquierda, elementos, repeticiones, contador);
+    elementos[*contador] = nodo->elemento;
+    repeticiones[(*contador)++] = repeticiones_de(arbol, nodo);
+    aplanar(arbol, nodo->derecha, elementos, repeticiones, contador);
+}
+
+/*
+ * Intercala los elementos del arbol, ubicados a partir de la posicion
+ * 'cantidad' de elementos y repeticiones, con los nuevos, dejando el
+ * resultado al principio de los mismos vectores (nunca se pisa un
+ * elemento que no se haya leido). Ante elementos iguales quedan primero
+ * los del arbol, igual que al insertar de a uno.
+ * En modo multiconjunto, los nuevos iguales al anterior se suman a sus
+ * repeticiones y se guardan en descartados para ser destruidos, salvo
+ * que sean el mismo puntero que el conservado o que el ultimo descartado.
+ *
+ * Devuelve la cantidad de elementos del resultado.
+ */
+static size_t intercalar(abb_t* arbol, void** elementos, size_t* repeticiones, size_t presentes,
+                         void** nuevos, size_t cantidad, void** descartados,
+                         size_t* cantidad_descartados)
+{
+    size_t i = 0, j = 0, k = 0;
+    while (i < presentes || j < cantidad)
+    {
+        void*  elemento = NULL;
+        size_t repeticion = 1;
+        if (j == cantidad ||
+            (i < presentes && arbol->comparador(nuevos[j], elementos[cantidad + i]) >= 0))
+        {
+            elemento = elementos[cantidad + i];
+            repeticion = repeticiones[cantidad + i];
+            i++;
+        }
+        else
+            elemento = nuevos[j++];
+        if (arbol->multiconjunto && k > 0 && arbol->comparador(elemento, elementos[k - 1]) == 0)
+        {
+            repeticiones[k - 1] += repeticion;
+            bool repetido = elemento == elementos[k - 1] ||
+                            (*cantidad_descartados &&
+                             elemento == descartados[*cantidad_descartados - 1]);
+            if (!repetido)
+                descartados[(*cantidad_descartados)++] = elemento;
+            continue;
+        }
+        elementos[k] = elemento;
+        repeticiones[k++] = repeticion;
+    }
+    return k;
+}
+
+/*
+ * Cuenta los nodos del subarbol.
+ */
+static size_t contar_nodos(nodo_abb_t* nodo)
+{
+    if (!nodo)
+        return 0;
+    return 1 + contar_nodos(nodo->izquierda) + contar_nodos(nodo->derecha);
+}
+
+/*
+ * Devuelve al pool todos los nodos del subarbol, sin destruir los
+ * elementos.
+ */
+static void liberar_nodos(struct pool_nodos* pool, nodo_abb_t* nodo)
+{
+    if (!nodo)
+        return;
+    liberar_nodos(pool, nodo->izquierda);
+    liberar_nodos(pool, nodo->derecha);
+    pool_liberar(pool, nodo);
+}
+
+/*
+ * Inserta en el arbol todos los elementos de un vector ordenado de
+ * menor a mayor segun el comparador. Los elementos se intercalan con
+ * los del arbol y el arbol se reconstruye balanceado, en tiempo lineal
+ * respecto de la cantidad total de elementos.
+ * Devuelve 0 si pudo insertar o -1 si no pudo (o si el vector no esta
+ * ordenado), en cuyo caso el arbol queda como estaba.
+ */
+int arbol_insertar_ordenados(abb_t* arbol, void** elementos, size_t cantidad)
+{
+    if (!arbol || (!elementos && cantidad))
+        return -1;
+    if (!esta_ordenado(arbol->comparador, elementos, cantidad))
+        return -1;
+    if (!cantidad)
+        return 0;
+
+    // Los nodos actuales se ubican al final para poder intercalar sobre los mismos vectores
+    size_t  maximo = arbol_cantidad(arbol) + cantidad;
+    void**  todos = malloc(maximo * sizeof(void*));
+    size_t* repeticiones = malloc(maximo * sizeof(size_t));
+    void**  descartados = arbol->multiconjunto ? malloc(cantidad * sizeof(void*)) : NULL;
+    if (!todos || !repeticiones || (arbol->multiconjunto && !descartados))
+    {
+        free(todos);
+        free(repeticiones);
+        free(descartados);
+        return -1;
+    }
+    size_t presentes = 0;
+    aplanar(arbol, arbol->nodo_raiz, todos + cantidad, repeticiones + cantidad, &presentes);
+    size_t cantidad_descartados = 0;
+    size_t total = intercalar(arbol, todos, repeticiones, presentes, elementos, cantidad,
+                              descartados, &cantidad_descartados);
+
+    // Se construye sobre un pool nuevo, asi ante un error el arbol original queda intacto
+    struct pool_nodos* pool = pool_crear(tamanio_nodo(arbol));
+    bool               error = !pool;
+    nodo_abb_t* raiz = construir_balanceado(arbol, pool, todos, repeticiones, 0, total, &error);
+    free(todos);
+    free(repeticiones);
+    if (error)
+    {
+        pool_destruir(pool);
+        free(descartados);
+        return -1;
+    }
+    // Si el pool es compartido con otro arbol, los nodos viejos se le devuelven de a uno
+    if (pool_es_compartido(arbol->pool))
+        liberar_nodos(arbol->pool, arbol->nodo_raiz);
+    pool_destruir(arbol->pool);
+    arbol->pool = pool;
+    arbol->nodo_raiz = raiz;
+    for (size_t i = 0; i < cantidad_descartados; i++)
+        destruir_elemento(descartados[i], arbol->destructor);
+    free(descartados);
+    return 0;
 }
 
 /*
- * Libera un nodo, utilizando el destructor.
+ * Libera un nodo devolviendolo al pool, utilizando el destructor.
  */
-static void liberar_nodo(nodo_abb_t* nodo, abb_liberar_elemento destructor)
+static void liberar_nodo(abb_t* arbol, nodo_abb_t* nodo)
 {
-    destruir_elemento(nodo->elemento, destructor);
-    free(nodo);
+    destruir_elemento(nodo->elemento, arbol->destructor);
+    pool_liberar(arbol->pool, nodo);
 }
 
 /*
  * Busca y elimina el nodo mas a la derecha de un arbol.
- * Guarda en elemento, el dato del nodo eliminado.
+ * Guarda en elemento y repeticiones, el dato del nodo eliminado.
  * Devuelve el hijo izquierdo del nodo eliminado.
  */
-static nodo_abb_t* predecesor_inorden(nodo_abb_t* nodo, void** elemento)
+static nodo_abb_t* predecesor_inorden(abb_t* arbol, nodo_abb_t* nodo, void** elemento,
+                                      size_t* repeticiones)
 {
     if (!nodo->derecha)
     {
         *elemento = nodo->elemento;
+        *repeticiones = repeticiones_de(arbol, nodo);
         nodo_abb_t* auxiliar = nodo->izquierda;
-        free(nodo);
+        pool_liberar(arbol->pool, nodo);
         return auxiliar;
     }
-    nodo->derecha = predecesor_inorden(nodo->derecha, elemento);
+    nodo->derecha = predecesor_inorden(arbol, nodo->derecha, elemento, repeticiones);
+    actualizar(arbol, nodo);
     return nodo;
 }
 
 /*
  * Funcion recursiva para eliminar un elemento del arbol.
- * Recibe un nodo de un arbol valido,
- * una funcion destructura(opcional),
- * una funcion comparadora,
- * el elemento a borrar,
+ * Recibe el arbol (del que se usan el comparador, el destructor y el pool),
+ * un nodo de un arbol valido,
+ * la clave del elemento a borrar,
  * y un puntero a un bool, el cual debe ser false en la primera llamada(En caso de ser true en la
  * primera llamada, la funcion devolvera siempre NULL)
  *
@@ -147,9 +540,9 @@ static nodo_abb_t* predecesor_inorden(nodo_abb_t* nodo, void** elemento)
  * En caso de no encontrar el elemento, se cambia la bandera de no_encontre, haciendo que las
  * llamadas devuelvan NULL
  */
-static nodo_abb_t* borrar(nodo_abb_t* nodo, abb_liberar_elemento destructor,
-                          abb_comparador comparador, void* elemento, bool* no_encontre)
+static nodo_abb_t* borrar(abb_t* arbol, nodo_abb_t* nodo, clave_t* clave, bool* no_encontre)
 {
+    abb_comparador comparador = arbol->comparador;
     if (!comparador) // No puedo comparar, imposible eliminar. Nunca va a entrar en la recursividad
         return NULL;
     if (!nodo) // Se llego al final del recorrido, no se encontro un elemento a buscar.
@@ -157,22 +550,26 @@ static nodo_abb_t* borrar(nodo_abb_t* nodo, abb_liberar_elemento destructor,
         *no_encontre = true;
         return NULL;
     }
+    int comparacion = comparar(arbol, clave, nodo);
     // El elemento a buscar es menor, pongo en evaluacion la rama izquierda
-    if (comparador(elemento, nodo->elemento) == -1)
+    if (comparacion == -1)
     {
-        nodo_abb_t* aux = borrar(nodo->izquierda, destructor, comparador, elemento, no_encontre);
+        nodo_abb_t* aux = borrar(arbol, nodo->izquierda, clave, no_encontre);
         if (*no_encontre)
             return NULL;
         nodo->izquierda = aux;
     }
     // El elemento a buscar es mayor, pongo en evaluacion la rama derecha
-    else if (comparador(elemento, nodo->elemento) == 1)
+    else if (comparacion == 1)
     {
-        nodo_abb_t* aux = borrar(nodo->derecha, destructor, comparador, elemento, no_encontre);
+        nodo_abb_t* aux = borrar(arbol, nodo->derecha, clave, no_encontre);
         if (*no_encontre)
             return NULL;
         nodo->derecha = aux;
     }
+    // En modo multiconjunto el elemento tiene repeticiones, se descuenta una
+    else if (repeticiones_de(arbol, nodo) > 1)
+        fijar_repeticiones(arbol, nodo, repeticiones_de(arbol, nodo) - 1);
     // Es el nodo a eliminar, busco cuantos hijos tiene
     else
     {
@@ -180,22 +577,27 @@ static nodo_abb_t* borrar(nodo_abb_t* nodo, abb_liberar_elemento destructor,
         if (!nodo->izquierda)
         {
             nodo_abb_t* temp = nodo->derecha;
-            liberar_nodo(nodo, destructor);
+            liberar_nodo(arbol, nodo);
             return temp;
         }
         else if (!nodo->derecha)
         {
             nodo_abb_t* temp = nodo->izquierda;
-            liberar_nodo(nodo, destructor);
+            liberar_nodo(arbol, nodo);
             return temp;
         }
         // Tiene dos hijos, busco el predecesor, y hago el cambio de hijos y elementos
         // correspondiente.
-        void* elemento_predecesor = NULL;
-        nodo->izquierda = predecesor_inorden(nodo->izquierda, &elemento_predecesor);
-        destruir_elemento(nodo->elemento, destructor);
+        void*  elemento_predecesor = NULL;
+        size_t repeticiones_predecesor = 1;
+        nodo->izquierda = predecesor_inorden(arbol, nodo->izquierda, &elemento_predecesor,
+                                             &repeticiones_predecesor);
+        destruir_elemento(nodo->elemento, arbol->destructor);
         nodo->elemento = elemento_predecesor;
+        fijar_prefijo(arbol, nodo, calcular_prefijo(arbol, elemento_predecesor));
+        fijar_repeticiones(arbol, nodo, repeticiones_predecesor);
     }
+    actualizar(arbol, nodo);
     return nodo;
 }
 
@@ -211,8 +613,8 @@ int arbol_borrar(abb_t* arbol, void* elemento)
     if (!arbol)
         return -1;
     bool        flag = false;
-    nodo_abb_t* aux =
-        borrar(arbol->nodo_raiz, arbol->destructor, arbol->comparador, elemento, &flag);
+    clave_t     clave = crear_clave(arbol, elemento);
+    nodo_abb_t* aux = borrar(arbol, arbol->nodo_raiz, &clave, &flag);
     if (!aux && flag)
         return -1;
     arbol->nodo_raiz = aux;
@@ -220,199 +622,1192 @@ int arbol_borrar(abb_t* arbol, void* elemento)
 }
 
 /*
- * Funcion recursiva para buscar nodo.
- *
- * Devuelve el primer elemento en el arbol que sea igual al elemento
- * a buscar,o NULL en caso de el elemento a buscar no existe en el arbol
+ * Devuelve true si ambos descriptores de agregado son iguales.
  */
-static void* buscar(nodo_abb_t* nodo, abb_comparador comparador, void* elemento)
+static bool mismo_agregado(abb_agregado_t* uno, abb_agregado_t* otro)
 {
-    // LLego al final de la rama, no encontro el elemento
-    if (!nodo)
-        return NULL;
-    if (comparador(elemento, nodo->elemento) == 0)
-        return nodo->elemento;
-    else if (comparador(elemento, nodo->elemento) == -1)
-        return buscar(nodo->izquierda, comparador, elemento);
-    else
-        return buscar(nodo->derecha, comparador, elemento);
+    return uno->tamanio == otro->tamanio && uno->identidad == otro->identidad &&
+           uno->extraer == otro->extraer && uno->combinar == otro->combinar;
 }
 
 /*
- * Busca en el arbol un elemento igual al provisto (utilizando la
- * funcion de comparación).
+ * Crea un arbol vacio con la misma configuracion que el modelo, que
+ * comparte el pool de nodos del mismo.
  *
- * Devuelve el elemento encontrado o NULL si no lo encuentra.
+ * Devuelve el arbol creado o NULL en caso de error.
  */
-void* arbol_buscar(abb_t* arbol, void* elemento)
+static abb_t* arbol_crear_como(abb_t* modelo)
 {
-    if (!arbol || !elemento)
+    abb_t* arbol = calloc(1, sizeof(abb_t));
+    if (!arbol)
         return NULL;
-    return buscar(arbol->nodo_raiz, arbol->comparador, elemento);
+    arbol->comparador = modelo->comparador;
+    arbol->destructor = modelo->destructor;
+    arbol->autoajustable = modelo->autoajustable;
+    arbol->multiconjunto = modelo->multiconjunto;
+    arbol->agregado = modelo->agregado;
+    arbol->prefijo = modelo->prefijo;
+    arbol->pool = pool_compartir(modelo->pool);
+    return arbol;
 }
 
 /*
- * Devuelve el elemento almacenado como raiz o NULL si el árbol está
- * vacío o no existe.
+ * Rota el nodo hacia la derecha, su hijo izquierdo pasa a ser la raiz
+ * del subarbol.
+ * Devuelve la nueva raiz del subarbol.
  */
-void* arbol_raiz(abb_t* arbol)
+static nodo_abb_t* rotar_derecha(abb_t* arbol, nodo_abb_t* nodo)
 {
-    if (!arbol)
-        return NULL;
-    if (arbol_vacio(arbol))
-        return NULL;
-    return arbol->nodo_raiz->elemento;
+    nodo_abb_t* hijo = nodo->izquierda;
+    nodo->izquierda = hijo->derecha;
+    hijo->derecha = nodo;
+    actualizar(arbol, nodo);
+    actualizar(arbol, hijo);
+    return hijo;
 }
 
 /*
- * Determina si el árbol está vacío.
- * Devuelve true si está vacío o el arbol es NULL, false si el árbol tiene elementos.
+ * Rota el nodo hacia la izquierda, su hijo derecho pasa a ser la raiz
+ * del subarbol.
+ * Devuelve la nueva raiz del subarbol.
  */
-bool arbol_vacio(abb_t* arbol)
+static nodo_abb_t* rotar_izquierda(abb_t* arbol, nodo_abb_t* nodo)
 {
-    if (!arbol)
-        return true;
-    if (arbol->nodo_raiz)
-        return false;
-    return true;
+    nodo_abb_t* hijo = nodo->derecha;
+    nodo->derecha = hijo->izquierda;
+    hijo->izquierda = nodo;
+    actualizar(arbol, nodo);
+    actualizar(arbol, hijo);
+    return hijo;
 }
 
 /*
- * Funcion recursiva del recorrido inorden.
- * Llena el array hasta el tamaño indicado o hasta que se quede sin nodos.
- * Cada vez que llena un elemento, aumenta el contador en 1.
+ * Devuelve el peso del subarbol para el balance por peso: su cantidad
+ * de elementos mas uno, asi el subarbol vacio pesa 1.
  */
-void recorrido_inorden(nodo_abb_t* nodo, void** array, int tamanio_array, int* contador)
+static size_t peso(nodo_abb_t* nodo)
 {
-
-    if (!nodo)
-        return;
-    recorrido_inorden(nodo->izquierda, array, tamanio_array, contador);
-    if (*contador >= tamanio_array)
-        return;
-    array[(*contador)++] = nodo->elemento;
-    recorrido_inorden(nodo->derecha, array, tamanio_array, contador);
+    return tamanio(nodo) + 1;
 }
 
 /*
- * Llena el array del tamaño dado con los elementos de arbol
- * en secuencia inorden.
- * Devuelve la cantidad de elementos del array que pudo llenar (si el
- * espacio en el array no alcanza para almacenar todos los elementos,
- * llena hasta donde puede y devuelve la cantidad de elementos que
- * pudo poner).
+ * Determina si un subarbol del peso dado es demasiado pesado para tener
+ * de hermano a uno del peso liviano: si pesa mas de 5/2 veces lo que
+ * pesa el otro (2 * pesado > 5 * liviano, sin desbordar).
  */
-int arbol_recorrido_inorden(abb_t* arbol, void** array, int tamanio_array)
+static bool demasiado_pesado(size_t pesado, size_t liviano)
 {
-    int contador = 0;
-    if (arbol && array)
-        recorrido_inorden(arbol->nodo_raiz, array, tamanio_array, &contador);
-    return contador;
+    return liviano <= pesado / 2 && pesado - 2 * liviano > liviano / 2;
 }
 
 /*
- * Funcion recursiva del recorrido preorden.
- * Llena el array hasta el tamaño indicado o hasta que se quede sin nodos.
- * Cada vez que llena un elemento, aumenta el contador en 1.
+ * Determina si dos subarboles de los pesos dados pueden ser hermanos.
  */
-void recorrido_preorden(nodo_abb_t* nodo, void** array, int tamanio_array, int* contador)
+static bool parejos(size_t uno, size_t otro)
 {
-    if (*contador >= tamanio_array || !nodo)
-        return;
-    array[(*contador)++] = nodo->elemento;
-    recorrido_preorden(nodo->izquierda, array, tamanio_array, contador);
-    recorrido_preorden(nodo->derecha, array, tamanio_array, contador);
+    return !demasiado_pesado(uno, otro) && !demasiado_pesado(otro, uno);
 }
 
+static nodo_abb_t* juntar(abb_t* arbol, nodo_abb_t* izquierda, nodo_abb_t* nodo,
+                          nodo_abb_t* derecha);
+
 /*
- * Llena el array del tamaño dado con los elementos de arbol
- * en secuencia preorden.
- * Devuelve la cantidad de elementos del array que pudo llenar (si el
- * espacio en el array no alcanza para almacenar todos los elementos,
- * llena hasta donde puede y devuelve la cantidad de elementos que
- * pudo poner).
+ * Junta los subarboles con el nodo en el medio cuando izquierda es
+ * demasiado pesado: baja por su rama derecha hasta un subarbol parejo
+ * con derecha, cuelga ahi el nodo y rebalancea con rotaciones al volver.
+ * Devuelve la raiz del subarbol resultante.
  */
-int arbol_recorrido_preorden(abb_t* arbol, void** array, int tamanio_array)
+static nodo_abb_t* juntar_por_derecha(abb_t* arbol, nodo_abb_t* izquierda, nodo_abb_t* nodo,
+                                      nodo_abb_t* derecha)
 {
-    int contador = 0;
-    if (arbol && array)
-        recorrido_preorden(arbol->nodo_raiz, array, tamanio_array, &contador);
-    return contador;
+    nodo_abb_t* hijo = juntar(arbol, izquierda->derecha, nodo, derecha);
+    izquierda->derecha = hijo;
+    actualizar(arbol, izquierda);
+    size_t resto = peso(izquierda->izquierda);
+    if (parejos(resto, peso(hijo)))
+        return izquierda;
+    // Una rotacion alcanza si el nieto interno queda parejo con el resto, si no hacen falta dos
+    if (!hijo->izquierda || (parejos(resto, peso(hijo->izquierda)) &&
+                             parejos(resto + peso(hijo->izquierda), peso(hijo->derecha))))
+        return rotar_izquierda(arbol, izquierda);
+    izquierda->derecha = rotar_derecha(arbol, hijo);
+    return rotar_izquierda(arbol, izquierda);
 }
 
 /*
- * Funcion recursiva del recorrido postorden.
- * Llena el array hasta el tamaño indicado o hasta que se quede sin nodos.
- * Cada vez que llena un elemento, aumenta el contador en 1.
+ * Simetrica a juntar_por_derecha, para cuando derecha es demasiado pesado.
+ * Devuelve la raiz del subarbol resultante.
  */
-void recorrido_postorden(nodo_abb_t* nodo, void** array, int tamanio_array, int* contador)
+static nodo_abb_t* juntar_por_izquierda(abb_t* arbol, nodo_abb_t* izquierda, nodo_abb_t* nodo,
+                                        nodo_abb_t* derecha)
 {
-    if (!nodo)
-        return;
-    recorrido_postorden(nodo->izquierda, array, tamanio_array, contador);
-    recorrido_postorden(nodo->derecha, array, tamanio_array, contador);
-    if (*contador >= tamanio_array)
-        return;
-    array[(*contador)++] = nodo->elemento;
+    nodo_abb_t* hijo = juntar(arbol, izquierda, nodo, derecha->izquierda);
+    derecha->izquierda = hijo;
+    actualizar(arbol, derecha);
+    size_t resto = peso(derecha->derecha);
+    if (parejos(resto, peso(hijo)))
+        return derecha;
+    if (!hijo->derecha || (parejos(resto, peso(hijo->derecha)) &&
+                           parejos(resto + peso(hijo->derecha), peso(hijo->izquierda))))
+        return rotar_derecha(arbol, derecha);
+    derecha->izquierda = rotar_izquierda(arbol, hijo);
+    return rotar_derecha(arbol, derecha);
 }
 
 /*
- * Llena el array del tamaño dado con los elementos de arbol
- * en secuencia postorden.
- * Devuelve la cantidad de elementos del array que pudo llenar (si el
- * espacio en el array no alcanza para almacenar todos los elementos,
- * llena hasta donde puede y devuelve la cantidad de elementos que
- * pudo poner).
+ * Junta dos subarboles con el nodo en el medio (todos los elementos de
+ * izquierda menores o iguales al del nodo y los de derecha mayores o
+ * iguales). Si los subarboles estan balanceados por peso, el resultado
+ * tambien lo esta y se recorre solo la rama del mas pesado hasta la
+ * altura del otro, en tiempo O(log n).
+ * Devuelve la raiz del subarbol resultante.
  */
-int arbol_recorrido_postorden(abb_t* arbol, void** array, int tamanio_array)
+static nodo_abb_t* juntar(abb_t* arbol, nodo_abb_t* izquierda, nodo_abb_t* nodo,
+                          nodo_abb_t* derecha)
 {
-    int contador = 0;
-    if (arbol && array)
-        recorrido_postorden(arbol->nodo_raiz, array, tamanio_array, &contador);
-    return contador;
+    if (demasiado_pesado(peso(izquierda), peso(derecha)))
+        return juntar_por_derecha(arbol, izquierda, nodo, derecha);
+    if (demasiado_pesado(peso(derecha), peso(izquierda)))
+        return juntar_por_izquierda(arbol, izquierda, nodo, derecha);
+    nodo->izquierda = izquierda;
+    nodo->derecha = derecha;
+    actualizar(arbol, nodo);
+    return nodo;
 }
 
 /*
- * Destruccion recursiva de los nodos.
- *
- * Se recorren los nodos en postorden, eliminandolos uno por uno
- * si es necesario utilizando el destructor(si esta disponible).
+ * Funcion recursiva para dividir un subarbol.
+ * Deja en izquierda los nodos menores al pivote y en derecha el resto,
+ * reutilizando los nodos del camino hacia el pivote: cada uno se junta
+ * con lo que queda de su lado, asi las dos partes quedan balanceadas.
  */
-static void destruir_nodos(nodo_abb_t* nodo, abb_liberar_elemento destructor)
+static void dividir(abb_t* arbol, nodo_abb_t* nodo, clave_t* pivote, nodo_abb_t** izquierda,
+                    nodo_abb_t** derecha)
 {
     if (!nodo)
+    {
+        *izquierda = NULL;
+        *derecha = NULL;
         return;
-    destruir_nodos(nodo->izquierda, destructor);
-    destruir_nodos(nodo->derecha, destructor);
-    liberar_nodo(nodo, destructor);
+    }
+    nodo_abb_t* menores = nodo->izquierda;
+    nodo_abb_t* mayores = nodo->derecha;
+    // El nodo y su rama izquierda quedan a la izquierda, se divide la rama derecha
+    if (comparar(arbol, pivote, nodo) > 0)
+    {
+        dividir(arbol, mayores, pivote, &mayores, derecha);
+        *izquierda = juntar(arbol, menores, nodo, mayores);
+    }
+    else
+    {
+        dividir(arbol, menores, pivote, izquierda, &menores);
+        *derecha = juntar(arbol, menores, nodo, mayores);
+    }
 }
 
 /*
- * Destruye el arbol liberando la memoria reservada por el mismo.
- * Adicionalmente invoca el destructor con cada elemento presente en
- * el arbol.
+ * Divide el arbol en dos: en izquierda quedan los elementos menores al
+ * pivote y en derecha los mayores o iguales. Ambos arboles conservan la
+ * configuracion del original y comparten sus nodos, por lo que la
+ * division no copia elementos y toma tiempo proporcional a la altura.
+ * Las dos partes quedan balanceadas por peso (ninguna rama pesa mas de
+ * 5/2 veces su hermana) si el original lo estaba, y entonces la altura
+ * es O(log n), como en los arboles de arbol_crear_desde_ordenado,
+ * arbol_insertar_ordenados, arbol_cargar, arbol_dividir y arbol_unir.
+ * arbol_insertar y arbol_borrar no rebalancean.
+ * Si tiene exito, el arbol original deja de existir.
+ * Los dos arboles reservan sus nodos del mismo pool, que no es seguro
+ * entre hilos: no pueden modificarse desde hilos distintos a la vez.
+ * Devuelve 0 si pudo dividir o -1 si no pudo, en cuyo caso el arbol
+ * original queda intacto.
  */
-void arbol_destruir(abb_t* arbol)
+int arbol_dividir(abb_t* arbol, void* pivote, abb_t** izquierda, abb_t** derecha)
 {
-    if (!arbol)
-        return;
-    destruir_nodos(arbol->nodo_raiz, arbol->destructor);
+    if (!arbol || !izquierda || !derecha)
+        return -1;
+    abb_t* menores = arbol_crear_como(arbol);
+    abb_t* mayores = arbol_crear_como(arbol);
+    if (!menores || !mayores)
+    {
+        arbol_destruir(menores);
+        arbol_destruir(mayores);
+        return -1;
+    }
+    clave_t clave = crear_clave(arbol, pivote);
+    dividir(arbol, arbol->nodo_raiz, &clave, &menores->nodo_raiz, &mayores->nodo_raiz);
+    pool_destruir(arbol->pool);
     free(arbol);
+    *izquierda = menores;
+    *derecha = mayores;
+    return 0;
+}
+
+/*
+ * Devuelve el nodo mas a la izquierda del subarbol.
+ */
+static nodo_abb_t* minimo(nodo_abb_t* nodo)
+{
+    while (nodo->izquierda)
+        nodo = nodo->izquierda;
+    return nodo;
+}
+
+/*
+ * Devuelve el nodo mas a la derecha del subarbol.
+ */
+static nodo_abb_t* maximo(nodo_abb_t* nodo)
+{
+    while (nodo->derecha)
+        nodo = nodo->derecha;
+    return nodo;
+}
+
+/*
+ * Desengancha el nodo mas a la derecha del subarbol, sin liberarlo, y
+ * rebalancea el camino hasta el mismo.
+ * Guarda el nodo en quitado.
+ * Devuelve el subarbol sin el nodo.
+ */
+static nodo_abb_t* quitar_maximo(abb_t* arbol, nodo_abb_t* nodo, nodo_abb_t** quitado)
+{
+    if (!nodo->derecha)
+    {
+        *quitado = nodo;
+        return nodo->izquierda;
+    }
+    nodo_abb_t* derecha = quitar_maximo(arbol, nodo->derecha, quitado);
+    return juntar(arbol, nodo->izquierda, nodo, derecha);
+}
+
+/*
+ * Suma repeticiones al nodo mas a la izquierda del subarbol, recalculando
+ * el tamaño de los nodos del camino.
+ */
+static void sumar_al_minimo(abb_t* arbol, nodo_abb_t* nodo, size_t repeticiones)
+{
+    if (nodo->izquierda)
+        sumar_al_minimo(arbol, nodo->izquierda, repeticiones);
+    else
+        fijar_repeticiones(arbol, nodo, repeticiones_de(arbol, nodo) + repeticiones);
+    actualizar(arbol, nodo);
+}
+
+/*
+ * Copia recursivamente el subarbol sobre los nodos reservados,
+ * devolviendo los nodos originales a su pool.
+ *
+ * Devuelve la copia del subarbol.
+ */
+static nodo_abb_t* migrar(abb_t* origen, nodo_abb_t* nodo, nodo_abb_t** reservados,
+                          size_t* contador)
+{
+    if (!nodo)
+        return NULL;
+    nodo_abb_t* copia = reservados[(*contador)++];
+    memcpy(copia, nodo, tamanio_nodo(origen));
+    copia->izquierda = migrar(origen, nodo->izquierda, reservados, contador);
+    copia->derecha = migrar(origen, nodo->derecha, reservados, contador);
+    pool_liberar(origen->pool, nodo);
+    return copia;
+}
+
+/*
+ * Lleva los nodos del arbol origen al pool de destino. Si el pool de
+ * origen no es compartido, destino absorbe sus bloques sin recorrer los
+ * nodos. Si no, los nodos se copian uno por uno.
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso nada cambia.
+ */
+static int mudar_nodos(abb_t* destino, abb_t* origen)
+{
+    if (destino->pool == origen->pool)
+        return 0;
+    if (pool_absorber(destino->pool, origen->pool) == 0)
+    {
+        origen->pool = pool_compartir(destino->pool);
+        return 0;
+    }
+    size_t       cantidad = contar_nodos(origen->nodo_raiz);
+    nodo_abb_t** reservados = malloc((cantidad ? cantidad : 1) * sizeof(nodo_abb_t*));
+    if (!reservados)
+        return -1;
+    for (size_t i = 0; i < cantidad; i++)
+    {
+        reservados[i] = pool_reservar(destino->pool);
+        if (!reservados[i])
+        {
+            while (i > 0)
+                pool_liberar(destino->pool, reservados[--i]);
+            free(reservados);
+            return -1;
+        }
+    }
+    size_t contador = 0;
+    origen->nodo_raiz = migrar(origen, origen->nodo_raiz, reservados, &contador);
+    free(reservados);
+    pool_destruir(origen->pool);
+    origen->pool = pool_compartir(destino->pool);
+    return 0;
+}
+
+/*
+ * Une dos arboles con la misma configuracion, donde todos los elementos
+ * de izquierda son menores o iguales a los de derecha. El resultado
+ * queda en izquierda y derecha deja de existir. En modo multiconjunto,
+ * si el mayor de izquierda es igual al menor de derecha se suman sus
+ * repeticiones, se conserva el de izquierda y el de derecha se
+ * descarta. La union toma tiempo proporcional a la altura, salvo que
+ * derecha comparta su pool con un arbol distinto de izquierda, en cuyo
+ * caso se copian sus nodos. Si los dos arboles estan balanceados por
+ * peso (ver arbol_dividir), el resultado tambien lo esta.
+ * Devuelve 0 si pudo unir o -1 si no pudo, en cuyo caso ambos arboles
+ * quedan intactos.
+ */
+int arbol_unir(abb_t* izquierda, abb_t* derecha)
+{
+    if (!izquierda || !derecha || izquierda == derecha)
+        return -1;
+    if (izquierda->comparador != derecha->comparador ||
+        izquierda->destructor != derecha->destructor ||
+        izquierda->multiconjunto != derecha->multiconjunto ||
+        izquierda->prefijo != derecha->prefijo ||
+        !mismo_agregado(&izquierda->agregado, &derecha->agregado))
+        return -1;
+    if (izquierda->nodo_raiz && derecha->nodo_raiz &&
+        izquierda->comparador(maximo(izquierda->nodo_raiz)->elemento,
+                              minimo(derecha->nodo_raiz)->elemento) > 0)
+        return -1;
+    if (mudar_nodos(izquierda, derecha) == -1)
+        return -1;
+
+    nodo_abb_t* raiz = derecha->nodo_raiz;
+    nodo_abb_t* resto = izquierda->nodo_raiz;
+    nodo_abb_t* nuevo = NULL;
+    if (resto)
+        resto = quitar_maximo(izquierda, resto, &nuevo);
+    // En modo multiconjunto, si el maximo y el minimo son iguales se juntan en un solo nodo,
+    // que conserva el elemento de izquierda
+    nodo_abb_t* menor = raiz ? minimo(raiz) : NULL;
+    if (nuevo && menor && izquierda->multiconjunto &&
+        izquierda->comparador(nuevo->elemento, menor->elemento) == 0)
+    {
+        if (menor->elemento != nuevo->elemento)
+            destruir_elemento(menor->elemento, izquierda->destructor);
+        menor->elemento = nuevo->elemento;
+        sumar_al_minimo(izquierda, raiz, repeticiones_de(izquierda, nuevo));
+        pool_liberar(izquierda->pool, nuevo);
+        nuevo = NULL;
+        if (resto)
+            resto = quitar_maximo(izquierda, resto, &nuevo);
+    }
+    // El maximo de izquierda junta los dos arboles, con cada uno de un lado
+    if (nuevo)
+        raiz = juntar(izquierda, resto, nuevo, raiz);
+    izquierda->nodo_raiz = raiz;
+    pool_destruir(derecha->pool);
+    free(derecha);
+    return 0;
+}
+
+/*
+ * Funcion recursiva de splay. Lleva a la raiz del subarbol el nodo igual
+ * al elemento, o el ultimo nodo visitado si no hay ninguno igual,
+ * rotando de a dos niveles (zig-zig / zig-zag) para acortar el camino.
+ *
+ * Devuelve la nueva raiz del subarbol.
+ */
+static nodo_abb_t* splay(abb_t* arbol, nodo_abb_t* nodo, clave_t* clave)
+{
+    if (!nodo)
+        return NULL;
+    int comparacion = comparar(arbol, clave, nodo);
+    if (comparacion < 0 && nodo->izquierda)
+    {
+        int comparacion_hijo = comparar(arbol, clave, nodo->izquierda);
+        if (comparacion_hijo < 0)
+        {
+            nodo->izquierda->izquierda = splay(arbol, nodo->izquierda->izquierda, clave);
+            nodo = rotar_derecha(arbol, nodo);
+        }
+        else if (comparacion_hijo > 0)
+        {
+            nodo->izquierda->derecha = splay(arbol, nodo->izquierda->derecha, clave);
+            if (nodo->izquierda->derecha)
+                nodo->izquierda = rotar_izquierda(arbol, nodo->izquierda);
+        }
+        return nodo->izquierda ? rotar_derecha(arbol, nodo) : nodo;
+    }
+    if (comparacion > 0 && nodo->derecha)
+    {
+        int comparacion_hijo = comparar(arbol, clave, nodo->derecha);
+        if (comparacion_hijo > 0)
+        {
+            nodo->derecha->derecha = splay(arbol, nodo->derecha->derecha, clave);
+            nodo = rotar_izquierda(arbol, nodo);
+        }
+        else if (comparacion_hijo < 0)
+        {
+            nodo->derecha->izquierda = splay(arbol, nodo->derecha->izquierda, clave);
+            if (nodo->derecha->izquierda)
+                nodo->derecha = rotar_derecha(arbol, nodo->derecha);
+        }
+        return nodo->derecha ? rotar_izquierda(arbol, nodo) : nodo;
+    }
+    return nodo;
+}
+
+/*
+ * Activa o desactiva el modo autoajustable. En este modo cada busqueda
+ * lleva el elemento buscado (o el ultimo visitado, si no se encuentra)
+ * a la raiz mediante rotaciones (splay), de forma que los elementos
+ * accedidos con frecuencia quedan cerca de la raiz.
+ * En este modo arbol_buscar modifica la forma del arbol.
+ */
+void arbol_modo_autoajustable(abb_t* arbol, bool activar)
+{
+    if (arbol)
+        arbol->autoajustable = activar;
+}
+
+/*
+ * Funcion recursiva para copiar un subarbol al pool con el formato de
+ * nodo de la configuracion. Calcula el prefijo de cada copia con la
+ * funcion de la configuracion, y su tamaño y agregado despues de copiar
+ * sus hijos.
+ * Devuelve la copia del subarbol, o NULL con error en true si no pudo.
+ */
+static nodo_abb_t* copiar_nodos(abb_t* arbol, abb_t* configuracion, struct pool_nodos* pool,
+                                nodo_abb_t* nodo, bool* error)
+{
+    if (!nodo || *error)
+        return NULL;
+    nodo_abb_t* copia = pool_reservar(pool);
+    if (!copia)
+    {
+        *error = true;
+        return NULL;
+    }
+    copia->elemento = nodo->elemento;
+    copia->izquierda = copiar_nodos(arbol, configuracion, pool, nodo->izquierda, error);
+    copia->derecha = copiar_nodos(arbol, configuracion, pool, nodo->derecha, error);
+    if (*error)
+        return NULL;
+    fijar_repeticiones(configuracion, copia, repeticiones_de(arbol, nodo));
+    fijar_prefijo(configuracion, copia, calcular_prefijo(configuracion, nodo->elemento));
+    actualizar(configuracion, copia);
+    return copia;
+}
+
+/*
+ * Cambia el modo multiconjunto, el agregado y el prefijo del arbol por
+ * los de la configuracion. Los nodos solo tienen los campos opcionales
+ * que usa la configuracion, asi que cambian de tamaño: se empieza un
+ * pool nuevo y, si el arbol tiene elementos, se copian sus nodos.
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso el arbol queda intacto.
+ */
+static int reconfigurar(abb_t* arbol, abb_t* configuracion)
+{
+    struct pool_nodos* pool = pool_crear(tamanio_nodo(configuracion));
+    bool               error = !pool;
+    nodo_abb_t* raiz = copiar_nodos(arbol, configuracion, pool, arbol->nodo_raiz, &error);
+    if (error)
+    {
+        pool_destruir(pool);
+        return -1;
+    }
+    // Si el pool es compartido con otro arbol, los nodos viejos se le devuelven de a uno
+    if (pool_es_compartido(arbol->pool))
+        liberar_nodos(arbol->pool, arbol->nodo_raiz);
+    pool_destruir(arbol->pool);
+    arbol->nodo_raiz = raiz;
+    arbol->pool = pool;
+    arbol->multiconjunto = configuracion->multiconjunto;
+    arbol->agregado = configuracion->agregado;
+    arbol->prefijo = configuracion->prefijo;
+    return 0;
+}
+
+/*
+ * Activa o desactiva el modo multiconjunto. Solo puede cambiarse con el
+ * arbol vacio. En este modo los elementos iguales no ocupan un nodo
+ * cada uno: el arbol conserva el primer elemento insertado y cuenta sus
+ * repeticiones. Al insertar un elemento igual a uno existente se suma
+ * una repeticion y el arbol toma posesion del elemento insertado, que
+ * se descarta destruyendolo en el momento, salvo que sea el mismo
+ * puntero que el conservado (por ejemplo, al contar un mismo elemento
+ * insertandolo varias veces). El elemento conservado nunca se destruye
+ * por un repetido. Al borrar se descuenta una repeticion, y el elemento
+ * conservado se destruye cuando se borra la ultima. Los recorridos
+ * visitan el elemento conservado una vez por cada repeticion.
+ * Devuelve 0 si pudo cambiar el modo o -1 si no pudo.
+ */
+int arbol_modo_multiconjunto(abb_t* arbol, bool activar)
+{
+    if (!arbol || !arbol_vacio(arbol))
+        return -1;
+    abb_t configuracion = *arbol;
+    configuracion.multiconjunto = activar;
+    return reconfigurar(arbol, &configuracion);
+}
+
+/*
+ * Define el agregado que cada nodo mantiene sobre los elementos de su
+ * subarbol, o lo quita si agregado es NULL. Si el arbol tiene elementos,
+ * sus nodos se copian y el agregado se calcula de abajo hacia arriba en
+ * tiempo lineal. El descriptor se copia, pero la identidad debe seguir
+ * existiendo mientras exista el arbol.
+ * Devuelve 0 si pudo definir el agregado o -1 si no pudo.
+ */
+int arbol_definir_agregado(abb_t* arbol, const abb_agregado_t* agregado)
+{
+    if (!arbol)
+        return -1;
+    if (agregado && (!agregado->tamanio || !agregado->identidad || !agregado->extraer ||
+                     !agregado->combinar))
+        return -1;
+    abb_t configuracion = *arbol;
+    if (agregado)
+        configuracion.agregado = *agregado;
+    else
+        configuracion.agregado = (abb_agregado_t){0};
+    return reconfigurar(arbol, &configuracion);
+}
+
+/*
+ * Define la funcion que calcula el prefijo de cada elemento, o la quita
+ * si prefijo es NULL. El prefijo se guarda en cada nodo y las busquedas
+ * comparan primero los prefijos, llamando al comparador solo cuando son
+ * iguales. Si el arbol tiene elementos, sus nodos se copian calculando
+ * el prefijo de cada uno; como el prefijo respeta el orden del
+ * comparador, la forma del arbol no cambia.
+ * Devuelve 0 si pudo definir el prefijo o -1 si no pudo.
+ */
+int arbol_definir_prefijo(abb_t* arbol, abb_prefijo prefijo)
+{
+    if (!arbol)
+        return -1;
+    abb_t configuracion = *arbol;
+    configuracion.prefijo = prefijo;
+    return reconfigurar(arbol, &configuracion);
+}
+
+/*
+ * Funcion recursiva para buscar nodo.
+ *
+ * Devuelve el primer elemento en el arbol que sea igual al elemento
+ * a buscar,o NULL en caso de el elemento a buscar no existe en el arbol
+ */
+static void* buscar(abb_t* arbol, nodo_abb_t* nodo, clave_t* clave)
+{
+    // LLego al final de la rama, no encontro el elemento
+    if (!nodo)
+        return NULL;
+    int comparacion = comparar(arbol, clave, nodo);
+    if (comparacion == 0)
+        return nodo->elemento;
+    else if (comparacion == -1)
+        return buscar(arbol, nodo->izquierda, clave);
+    else
+        return buscar(arbol, nodo->derecha, clave);
+}
+
+/*
+ * Busca en el arbol un elemento igual al provisto (utilizando la
+ * funcion de comparación).
+ *
+ * Devuelve el elemento encontrado o NULL si no lo encuentra.
+ */
+void* arbol_buscar(abb_t* arbol, void* elemento)
+{
+    if (!arbol || !elemento)
+        return NULL;
+    clave_t clave = crear_clave(arbol, elemento);
+    if (arbol->autoajustable)
+    {
+        arbol->nodo_raiz = splay(arbol, arbol->nodo_raiz, &clave);
+        if (arbol->nodo_raiz && comparar(arbol, &clave, arbol->nodo_raiz) == 0)
+            return arbol->nodo_raiz->elemento;
+        return NULL;
+    }
+    return buscar(arbol, arbol->nodo_raiz, &clave);
+}
+
+/*
+ * Devuelve el elemento almacenado como raiz o NULL si el árbol está
+ * vacío o no existe.
+ */
+void* arbol_raiz(abb_t* arbol)
+{
+    if (!arbol)
+        return NULL;
+    if (arbol_vacio(arbol))
+        return NULL;
+    return arbol->nodo_raiz->elemento;
+}
+
+/*
+ * Determina si el árbol está vacío.
+ * Devuelve true si está vacío o el arbol es NULL, false si el árbol tiene elementos.
+ */
+bool arbol_vacio(abb_t* arbol)
+{
+    if (!arbol)
+        return true;
+    if (arbol->nodo_raiz)
+        return false;
+    return true;
+}
+
+/*
+ * Devuelve la cantidad de elementos almacenados en el arbol o 0 si el
+ * arbol no existe.
+ */
+size_t arbol_cantidad(abb_t* arbol)
+{
+    if (!arbol)
+        return 0;
+    return tamanio(arbol->nodo_raiz);
+}
+
+/*
+ * Devuelve el k-esimo elemento del arbol en orden, donde 0 es el
+ * menor elemento, o NULL si no existe dicha posicion.
+ */
+void* arbol_kesimo(abb_t* arbol, size_t k)
+{
+    if (!arbol || k >= arbol_cantidad(arbol))
+        return NULL;
+    nodo_abb_t* nodo = arbol->nodo_raiz;
+    while (nodo)
+    {
+        size_t menores = tamanio(nodo->izquierda);
+        if (k < menores)
+            nodo = nodo->izquierda;
+        else if (k < menores + repeticiones_de(arbol, nodo))
+            return nodo->elemento;
+        else
+        {
+            k -= menores + repeticiones_de(arbol, nodo);
+            nodo = nodo->derecha;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Devuelve la cantidad de elementos del arbol que son menores al
+ * elemento provisto (utilizando la funcion de comparación), es decir,
+ * la posicion que ocuparia el elemento en un recorrido inorden.
+ * El elemento no necesita estar en el arbol.
+ */
+size_t arbol_rango_de(abb_t* arbol, void* elemento)
+{
+    if (!arbol)
+        return 0;
+    size_t      rango = 0;
+    clave_t     clave = crear_clave(arbol, elemento);
+    nodo_abb_t* nodo = arbol->nodo_raiz;
+    while (nodo)
+    {
+        // Los iguales pueden estar en ambas ramas, asi que solo se descarta el nodo si es menor
+        if (comparar(arbol, &clave, nodo) > 0)
+        {
+            rango += tamanio(nodo->izquierda) + repeticiones_de(arbol, nodo);
+            nodo = nodo->derecha;
+        }
+        else
+            nodo = nodo->izquierda;
+    }
+    return rango;
+}
+
+/*
+ * Combina en resultado el valor que aporta el nodo, sin sus ramas.
+ * Usa auxiliar para guardar el valor extraido del elemento.
+ */
+static void agregar_nodo(abb_t* arbol, nodo_abb_t* nodo, void* resultado, void* auxiliar)
+{
+    arbol->agregado.extraer(nodo->elemento, repeticiones_de(arbol, nodo), auxiliar);
+    arbol->agregado.combinar(resultado, auxiliar, resultado);
+}
+
+/*
+ * Funcion recursiva que combina en resultado, en orden, los agregados
+ * de los elementos del subarbol entre las claves desde y hasta (NULL es
+ * sin limite). Una vez que el nodo cae dentro del rango, cada rama queda
+ * acotada de un solo lado, por lo que se visitan a lo sumo dos caminos.
+ */
+static void agregar_rango(abb_t* arbol, nodo_abb_t* nodo, clave_t* desde, clave_t* hasta,
+                          void* resultado, void* auxiliar)
+{
+    if (!nodo)
+        return;
+    // Sin limites se usa el agregado guardado de todo el subarbol
+    if (!desde && !hasta)
+        arbol->agregado.combinar(resultado, agregado_de(arbol, nodo), resultado);
+    else if (desde && comparar(arbol, desde, nodo) > 0)
+        agregar_rango(arbol, nodo->derecha, desde, hasta, resultado, auxiliar);
+    else if (hasta && comparar(arbol, hasta, nodo) < 0)
+        agregar_rango(arbol, nodo->izquierda, desde, hasta, resultado, auxiliar);
+    else
+    {
+        agregar_rango(arbol, nodo->izquierda, desde, NULL, resultado, auxiliar);
+        agregar_nodo(arbol, nodo, resultado, auxiliar);
+        agregar_rango(arbol, nodo->derecha, NULL, hasta, resultado, auxiliar);
+    }
+}
+
+/*
+ * Calcula el agregado de los elementos entre desde y hasta (incluidos),
+ * combinados de menor a mayor, y lo guarda en resultado. Desde o hasta
+ * pueden ser NULL, indicando que no hay limite de ese lado. Si no hay
+ * elementos en el rango, el resultado es la identidad. Toma tiempo
+ * proporcional a la altura del arbol.
+ * Devuelve 0 si pudo calcularlo o -1 en caso de error, o si el arbol no
+ * tiene agregado.
+ */
+int arbol_agregar_rango(abb_t* arbol, void* desde, void* hasta, void* resultado)
+{
+    if (!arbol || !resultado || !arbol->agregado.tamanio)
+        return -1;
+    // Los agregados chicos usan un auxiliar en la pila, sin reservar memoria por consulta
+    _Alignas(max_align_t) unsigned char local[AGREGADO_EN_PILA];
+    void* auxiliar = local;
+    if (arbol->agregado.tamanio > sizeof(local))
+        auxiliar = malloc(arbol->agregado.tamanio);
+    if (!auxiliar)
+        return -1;
+    clave_t clave_desde;
+    clave_t clave_hasta;
+    if (desde)
+        clave_desde = crear_clave(arbol, desde);
+    if (hasta)
+        clave_hasta = crear_clave(arbol, hasta);
+    memcpy(resultado, arbol->agregado.identidad, arbol->agregado.tamanio);
+    agregar_rango(arbol, arbol->nodo_raiz, desde ? &clave_desde : NULL,
+                  hasta ? &clave_hasta : NULL, resultado, auxiliar);
+    if (auxiliar != local)
+        free(auxiliar);
+    return 0;
+}
+
+/*
+ * Determina si el recorrido puede saltear el subarbol entero: si el
+ * array ya esta lleno, o si todos sus elementos caen antes de la
+ * posicion desde la que se empieza a llenar (en cuyo caso los descuenta
+ * de saltear).
+ */
+static bool saltear_subarbol(nodo_abb_t* nodo, size_t tamanio_array, size_t* contador,
+                             size_t* saltear)
+{
+    if (!nodo || *contador >= tamanio_array)
+        return true;
+    if (*saltear >= tamanio(nodo))
+    {
+        *saltear -= tamanio(nodo);
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Pone el elemento del nodo en el array (una vez por cada repeticion),
+ * descontando de saltear las repeticiones que caen antes de la posicion
+ * desde la que se empieza a llenar.
+ */
+static void visitar(abb_t* arbol, nodo_abb_t* nodo, void** array, size_t tamanio_array,
+                    size_t* contador, size_t* saltear)
+{
+    size_t repeticiones = repeticiones_de(arbol, nodo);
+    if (*saltear >= repeticiones)
+    {
+        *saltear -= repeticiones;
+        return;
+    }
+    repeticiones -= *saltear;
+    *saltear = 0;
+    while (repeticiones-- && *contador < tamanio_array)
+        array[(*contador)++] = nodo->elemento;
+}
+
+/*
+ * Funcion recursiva del recorrido inorden.
+ * Saltea los primeros elementos indicados por saltear y llena el array
+ * hasta el tamaño indicado o hasta que se quede sin nodos. Cada vez que
+ * llena un elemento, aumenta el contador en 1.
+ * Los subarboles que quedan enteros antes de la posicion inicial o
+ * despues de llenar el array no se recorren.
+ */
+void recorrido_inorden(abb_t* arbol, nodo_abb_t* nodo, void** array, size_t tamanio_array,
+                        size_t* contador, size_t* saltear)
+{
+    if (saltear_subarbol(nodo, tamanio_array, contador, saltear))
+        return;
+    recorrido_inorden(arbol, nodo->izquierda, array, tamanio_array, contador, saltear);
+    if (*contador >= tamanio_array)
+        return;
+    visitar(arbol, nodo, array, tamanio_array, contador, saltear);
+    recorrido_inorden(arbol, nodo->derecha, array, tamanio_array, contador, saltear);
+}
+
+/*
+ * Llena el array del tamaño dado con los elementos de arbol
+ * en secuencia inorden.
+ * Devuelve la cantidad de elementos del array que pudo llenar (si el
+ * espacio en el array no alcanza para almacenar todos los elementos,
+ * llena hasta donde puede y devuelve la cantidad de elementos que
+ * pudo poner).
+ */
+size_t arbol_recorrido_inorden(abb_t* arbol, void** array, size_t tamanio_array)
+{
+    size_t contador = 0;
+    size_t saltear = 0;
+    if (arbol && array)
+        recorrido_inorden(arbol, arbol->nodo_raiz, array, tamanio_array, &contador, &saltear);
+    return contador;
+}
+
+/*
+ * Funcion recursiva del recorrido preorden.
+ * Saltea los primeros elementos indicados por saltear y llena el array
+ * hasta el tamaño indicado o hasta que se quede sin nodos. Cada vez que
+ * llena un elemento, aumenta el contador en 1.
+ */
+void recorrido_preorden(abb_t* arbol, nodo_abb_t* nodo, void** array, size_t tamanio_array,
+                         size_t* contador, size_t* saltear)
+{
+    if (saltear_subarbol(nodo, tamanio_array, contador, saltear))
+        return;
+    visitar(arbol, nodo, array, tamanio_array, contador, saltear);
+    recorrido_preorden(arbol, nodo->izquierda, array, tamanio_array, contador, saltear);
+    recorrido_preorden(arbol, nodo->derecha, array, tamanio_array, contador, saltear);
+}
+
+/*
+ * Llena el array del tamaño dado con los elementos de arbol
+ * en secuencia preorden.
+ * Devuelve la cantidad de elementos del array que pudo llenar (si el
+ * espacio en el array no alcanza para almacenar todos los elementos,
+ * llena hasta donde puede y devuelve la cantidad de elementos que
+ * pudo poner).
+ */
+size_t arbol_recorrido_preorden(abb_t* arbol, void** array, size_t tamanio_array)
+{
+    size_t contador = 0;
+    size_t saltear = 0;
+    if (arbol && array)
+        recorrido_preorden(arbol, arbol->nodo_raiz, array, tamanio_array, &contador, &saltear);
+    return contador;
+}
+
+/*
+ * Funcion recursiva del recorrido postorden.
+ * Saltea los primeros elementos indicados por saltear y llena el array
+ * hasta el tamaño indicado o hasta que se quede sin nodos. Cada vez que
+ * llena un elemento, aumenta el contador en 1.
+ */
+void recorrido_postorden(abb_t* arbol, nodo_abb_t* nodo, void** array, size_t tamanio_array,
+                          size_t* contador, size_t* saltear)
+{
+    if (saltear_subarbol(nodo, tamanio_array, contador, saltear))
+        return;
+    recorrido_postorden(arbol, nodo->izquierda, array, tamanio_array, contador, saltear);
+    recorrido_postorden(arbol, nodo->derecha, array, tamanio_array, contador, saltear);
+    if (*contador >= tamanio_array)
+        return;
+    visitar(arbol, nodo, array, tamanio_array, contador, saltear);
+}
+
+/*
+ * Llena el array del tamaño dado con los elementos de arbol
+ * en secuencia postorden.
+ * Devuelve la cantidad de elementos del array que pudo llenar (si el
+ * espacio en el array no alcanza para almacenar todos los elementos,
+ * llena hasta donde puede y devuelve la cantidad de elementos que
+ * pudo poner).
+ */
+size_t arbol_recorrido_postorden(abb_t* arbol, void** array, size_t tamanio_array)
+{
+    size_t contador = 0;
+    size_t saltear = 0;
+    if (arbol && array)
+        recorrido_postorden(arbol, arbol->nodo_raiz, array, tamanio_array, &contador, &saltear);
+    return contador;
+}
+
+/*
+ * Llena el array del tamaño dado con la siguiente pagina de elementos
+ * del arbol en el recorrido solicitado, comenzando desde la posicion
+ * indicada por el cursor (0 para comenzar desde el principio). Al
+ * terminar, avanza el cursor hasta el primer elemento que no entro en
+ * el array, de forma que la siguiente llamada continue desde ahi.
+ * Los subarboles anteriores al cursor se saltean sin recorrerlos, por
+ * lo que obtener una pagina cuesta O(altura + tamanio_array).
+ * Los recorridos válidos son: ABB_RECORRER_INORDEN,
+ * ABB_RECORRER_PREORDEN y ABB_RECORRER_POSTORDEN.
+ * Devuelve la cantidad de elementos del array que pudo llenar. Una
+ * cantidad menor a tamanio_array indica que no quedan mas elementos.
+ */
+size_t arbol_recorrido_pagina(abb_t* arbol, int recorrido, size_t* cursor, void** array,
+                              size_t tamanio_array)
+{
+    size_t contador = 0;
+    if (!arbol || !cursor || !array)
+        return contador;
+    size_t saltear = *cursor;
+    if (recorrido == ABB_RECORRER_INORDEN)
+        recorrido_inorden(arbol, arbol->nodo_raiz, array, tamanio_array, &contador, &saltear);
+    else if (recorrido == ABB_RECORRER_PREORDEN)
+        recorrido_preorden(arbol, arbol->nodo_raiz, array, tamanio_array, &contador, &saltear);
+    else if (recorrido == ABB_RECORRER_POSTORDEN)
+        recorrido_postorden(arbol, arbol->nodo_raiz, array, tamanio_array, &contador, &saltear);
+    *cursor += contador;
+    return contador;
+}
+
+/*
+ * Destruye el arbol liberando la memoria reservada por el mismo.
+ * Adicionalmente invoca el destructor con cada elemento presente en
+ * el arbol.
+ */
+void arbol_destruir(abb_t* arbol)
+{
+    if (!arbol)
+        return;
+    if (arbol->destructor)
+        destruir_elementos(arbol->nodo_raiz, arbol->destructor);
+    // Si otro arbol sigue usando el pool, los nodos se le devuelven para que los reutilice
+    if (pool_es_compartido(arbol->pool))
+        liberar_nodos(arbol->pool, arbol->nodo_raiz);
+    pool_destruir(arbol->pool);
+    free(arbol);
+}
+
+/*
+ * Invoca la funcion con el elemento del nodo una vez por cada repeticion.
+ * Devuelve true si la funcion pidio cortar el recorrido.
+ */
+static bool visitar_elemento(abb_t* arbol, nodo_abb_t* nodo, bool (*funcion)(void*, void*),
+                             void* extra)
+{
+    for (size_t i = 0; i < repeticiones_de(arbol, nodo); i++)
+        if (funcion(nodo->elemento, extra))
+            return true;
+    return false;
+}
+
+/*
+ * Escribe un entero de 64 bits en little endian, para que el archivo
+ * no dependa de la arquitectura.
+ * Devuelve 0 si pudo o -1 si no pudo.
+ */
+static int escribir_entero(FILE* archivo, uint64_t valor)
+{
+    unsigned char bytes[8];
+    for (size_t i = 0; i < sizeof(bytes); i++)
+        bytes[i] = (unsigned char)(valor >> (8 * i));
+    return fwrite(bytes, sizeof(bytes), 1, archivo) == 1 ? 0 : -1;
+}
+
+/*
+ * Lee un entero de 64 bits escrito por escribir_entero.
+ * Devuelve 0 si pudo o -1 si no pudo.
+ */
+static int leer_entero(FILE* archivo, uint64_t* valor)
+{
+    unsigned char bytes[8];
+    if (fread(bytes, sizeof(bytes), 1, archivo) != 1)
+        return -1;
+    *valor = 0;
+    for (size_t i = 0; i < sizeof(bytes); i++)
+        *valor |= (uint64_t)bytes[i] << (8 * i);
+    return 0;
+}
+
+/*
+ * Escribe recursivamente en inorden los elementos de cada nodo (y sus
+ * repeticiones si corresponde).
+ * Devuelve 0 si pudo o -1 si no pudo.
+ */
+static int guardar_nodos(abb_t* arbol, nodo_abb_t* nodo, FILE* archivo, abb_serializar serializar)
+{
+    if (!nodo)
+        return 0;
+    if (guardar_nodos(arbol, nodo->izquierda, archivo, serializar) == -1)
+        return -1;
+    if (arbol->multiconjunto && escribir_entero(archivo, repeticiones_de(arbol, nodo)) == -1)
+        return -1;
+    if (serializar(nodo->elemento, archivo) == -1)
+        return -1;
+    return guardar_nodos(arbol, nodo->derecha, archivo, serializar);
+}
+
+/*
+ * Guarda el arbol en el archivo de la ruta dada, en un formato binario
+ * compacto: una cabecera con la cantidad de elementos, seguida de cada
+ * elemento en orden escrito con el serializador (y sus repeticiones si
+ * el arbol esta en modo multiconjunto).
+ * Devuelve 0 si pudo guardar o -1 si no pudo.
+ */
+int arbol_guardar(abb_t* arbol, const char* ruta, abb_serializar serializar)
+{
+    if (!arbol || !ruta || !serializar)
+        return -1;
+    FILE* archivo = fopen(ruta, "wb");
+    if (!archivo)
+        return -1;
+    setvbuf(archivo, NULL, _IOFBF, ARCHIVO_TAMANIO_BUFFER);
+    size_t nodos = arbol->multiconjunto ? contar_nodos(arbol->nodo_raiz) : arbol_cantidad(arbol);
+    int    estado = 0;
+    if (fwrite(ARCHIVO_FIRMA, strlen(ARCHIVO_FIRMA), 1, archivo) != 1 ||
+        escribir_entero(archivo, arbol->multiconjunto ? ARCHIVO_MULTICONJUNTO : 0) == -1 ||
+        escribir_entero(archivo, nodos) == -1 ||
+        guardar_nodos(arbol, arbol->nodo_raiz, archivo, serializar) == -1)
+        estado = -1;
+    if (fclose(archivo) != 0)
+        estado = -1;
+    return estado;
+}
+
+/*
+ * Lee la cabecera de un archivo guardado con arbol_guardar.
+ * Devuelve 0 si la cabecera es valida o -1 si no lo es.
+ */
+static int leer_cabecera(FILE* archivo, uint64_t* banderas, uint64_t* nodos)
+{
+    char firma[sizeof(ARCHIVO_FIRMA) - 1];
+    if (fread(firma, sizeof(firma), 1, archivo) != 1 || memcmp(firma, ARCHIVO_FIRMA, sizeof(firma)))
+        return -1;
+    if (leer_entero(archivo, banderas) == -1 || leer_entero(archivo, nodos) == -1)
+        return -1;
+    if (*banderas & ~(uint64_t)ARCHIVO_MULTICONJUNTO || *nodos > SIZE_MAX / sizeof(void*))
+        return -1;
+    return 0;
+}
+
+/*
+ * Duplica la capacidad de los arreglos de elementos y repeticiones,
+ * empezando por ARCHIVO_CAPACIDAD.
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso la capacidad no cambia.
+ */
+static int agrandar_arreglos(void*** elementos, size_t** repeticiones, size_t* capacidad)
+{
+    size_t nueva = *capacidad ? *capacidad * 2 : ARCHIVO_CAPACIDAD;
+    if (nueva > SIZE_MAX / sizeof(size_t))
+        return -1;
+    void** mas_elementos = realloc(*elementos, nueva * sizeof(void*));
+    if (!mas_elementos)
+        return -1;
+    *elementos = mas_elementos;
+    size_t* mas_repeticiones = realloc(*repeticiones, nueva * sizeof(size_t));
+    if (!mas_repeticiones)
+        return -1;
+    *repeticiones = mas_repeticiones;
+    *capacidad = nueva;
+    return 0;
+}
+
+/*
+ * Lee los elementos (y sus repeticiones si corresponde) del archivo.
+ * Los arreglos crecen a medida que se leen elementos, asi la cantidad
+ * de la cabecera no decide cuanta memoria se reserva.
+ * Devuelve la cantidad de elementos que pudo leer.
+ */
+static size_t leer_elementos(FILE* archivo, abb_deserializar deserializar, void*** elementos,
+                             size_t** repeticiones, uint64_t nodos, bool con_repeticiones)
+{
+    size_t leidos = 0;
+    size_t capacidad = 0;
+    while (leidos < nodos)
+    {
+        if (leidos == capacidad && agrandar_arreglos(elementos, repeticiones, &capacidad) == -1)
+            break;
+        uint64_t repeticion = 1;
+        if (con_repeticiones && (leer_entero(archivo, &repeticion) == -1 || !repeticion))
+            break;
+        void* elemento = deserializar(archivo);
+        if (!elemento)
+            break;
+        (*elementos)[leidos] = elemento;
+        (*repeticiones)[leidos++] = (size_t)repeticion;
+    }
+    return leidos;
+}
+
+/*
+ * Crea un arbol con los elementos guardados con arbol_guardar en el
+ * archivo de la ruta dada, leyendo cada elemento con el deserializador.
+ * El arbol se reconstruye balanceado en tiempo lineal. La memoria se
+ * reserva a medida que se leen los elementos, no segun la cantidad que
+ * declara la cabecera, y un archivo con datos despues del ultimo
+ * elemento se rechaza.
+ * Comparador y destructor cumplen la misma funcion que en arbol_crear.
+ *
+ * Devuelve un puntero al arbol creado o NULL en caso de error. En caso
+ * de error, los elementos que se hayan leido se destruyen.
+ */
+abb_t* arbol_cargar(const char* ruta, abb_comparador comparador, abb_liberar_elemento destructor,
+                    abb_deserializar deserializar)
+{
+    if (!ruta || !comparador || !deserializar)
+        return NULL;
+    FILE* archivo = fopen(ruta, "rb");
+    if (!archivo)
+        return NULL;
+    setvbuf(archivo, NULL, _IOFBF, ARCHIVO_TAMANIO_BUFFER);
+    uint64_t banderas = 0, nodos = 0;
+    if (leer_cabecera(archivo, &banderas, &nodos) == -1)
+    {
+        fclose(archivo);
+        return NULL;
+    }
+    abb_t*  arbol = arbol_crear(comparador, destructor);
+    void**  elementos = NULL;
+    size_t* repeticiones = NULL;
+    size_t  leidos = 0;
+    bool    error = !arbol;
+    if (!error)
+        error = arbol_modo_multiconjunto(arbol, banderas & ARCHIVO_MULTICONJUNTO) == -1;
+    if (!error)
+    {
+        leidos = leer_elementos(archivo, deserializar, &elementos, &repeticiones, nodos,
+                                arbol->multiconjunto);
+        // Despues del ultimo elemento el archivo tiene que terminar
+        error = leidos != nodos || fgetc(archivo) != EOF ||
+                !esta_ordenado(comparador, elementos, leidos);
+    }
+    fclose(archivo);
+    if (!error)
+        arbol->nodo_raiz =
+            construir_balanceado(arbol, arbol->pool, elementos, repeticiones, 0, leidos, &error);
+    if (error)
+    {
+        for (size_t i = 0; i < leidos; i++)
+            destruir_elemento(elementos[i], destructor);
+        if (arbol)
+        {
+            arbol->destructor = NULL;
+            arbol_destruir(arbol);
+        }
+        arbol = NULL;
+    }
+    free(elementos);
+    free(repeticiones);
+    return arbol;
 }
 
 /*
  * Recorrido inorden para iterador interno.
  * Deja de recorrer cuando la funcion devuelva true
  */
-bool inorden(nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
+bool inorden(abb_t* arbol, nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
 {
     if (!nodo)
         return false;
-    if (inorden(nodo->izquierda, funcion, extra))
+    if (inorden(arbol, nodo->izquierda, funcion, extra))
         return true;
-    if (funcion(nodo->elemento, extra))
+    if (visitar_elemento(arbol, nodo, funcion, extra))
         return true;
-    if (inorden(nodo->derecha, funcion, extra))
+    if (inorden(arbol, nodo->derecha, funcion, extra))
         return true;
     return false;
 }
@@ -421,15 +1816,15 @@ bool inorden(nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
  * Recorrido preorden para iterador interno.
  * Deja de recorrer cuando la funcion devuelva true
  */
-bool preorden(nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
+bool preorden(abb_t* arbol, nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
 {
     if (!nodo)
         return false;
-    if (funcion(nodo->elemento, extra))
+    if (visitar_elemento(arbol, nodo, funcion, extra))
         return true;
-    if (preorden(nodo->izquierda, funcion, extra))
+    if (preorden(arbol, nodo->izquierda, funcion, extra))
         return true;
-    if (preorden(nodo->derecha, funcion, extra))
+    if (preorden(arbol, nodo->derecha, funcion, extra))
         return true;
     return false;
 }
@@ -438,15 +1833,15 @@ bool preorden(nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
  * Recorrido postorden para iterador interno.
  * Deja de recorrer cuando la funcion devuelva true
  */
-bool postorden(nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
+bool postorden(abb_t* arbol, nodo_abb_t* nodo, bool (*funcion)(void*, void*), void* extra)
 {
     if (!nodo)
         return false;
-    if (postorden(nodo->izquierda, funcion, extra))
+    if (postorden(arbol, nodo->izquierda, funcion, extra))
         return true;
-    if (postorden(nodo->derecha, funcion, extra))
+    if (postorden(arbol, nodo->derecha, funcion, extra))
         return true;
-    if (funcion(nodo->elemento, extra))
+    if (visitar_elemento(arbol, nodo, funcion, extra))
         return true;
     return false;
 }
@@ -466,10 +1861,10 @@ void abb_con_cada_elemento(abb_t* arbol, int recorrido, bool (*funcion)(void*, v
     if (!arbol || !funcion)
         return;
     if (recorrido == ABB_RECORRER_INORDEN)
-        inorden(arbol->nodo_raiz, funcion, extra);
+        inorden(arbol, arbol->nodo_raiz, funcion, extra);
     else if (recorrido == ABB_RECORRER_PREORDEN)
-        preorden(arbol->nodo_raiz, funcion, extra);
+        preorden(arbol, arbol->nodo_raiz, funcion, extra);
     else if (recorrido == ABB_RECORRER_POSTORDEN)
-        postorden(arbol->nodo_raiz, funcion, extra);
+        postorden(arbol, arbol->nodo_raiz, funcion, extra);
     return;
 }
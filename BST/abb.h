@@ -6,6 +6,9 @@
 #define ABB_RECORRER_POSTORDEN 2
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 /*
@@ -17,22 +20,67 @@ typedef int (*abb_comparador)(void*, void*);
 
 /*
  * Destructor de elementos. Cada vez que un elemento deja el arbol
- * (arbol_borrar o arbol_destruir) se invoca al destructor pasandole
- * el elemento.
+ * (arbol_borrar o arbol_destruir) o se descarta por repetido en modo
+ * multiconjunto, se invoca al destructor pasandole el elemento.
  */
 typedef void (*abb_liberar_elemento)(void*);
 
+/*
+ * Serializador de elementos. Escribe el elemento en el archivo, en el
+ * formato que elija el usuario. Devuelve 0 si pudo o -1 si no pudo.
+ */
+typedef int (*abb_serializar)(void* elemento, FILE* archivo);
+
+/*
+ * Deserializador de elementos. Lee del archivo un elemento escrito por
+ * el serializador correspondiente y lo devuelve, o NULL si no pudo.
+ */
+typedef void* (*abb_deserializar)(FILE* archivo);
+
+/*
+ * Prefijo de elementos. Devuelve un entero de 64 bits que respeta el
+ * orden del comparador: si el prefijo de un elemento es menor al de
+ * otro, el elemento es menor, y dos elementos iguales tienen el mismo
+ * prefijo (por ejemplo, los primeros 8 bytes de una cadena en big
+ * endian).
+ */
+typedef uint64_t (*abb_prefijo)(void* elemento);
+
+/*
+ * Descriptor de un agregado que cada nodo mantiene sobre los elementos
+ * de su subarbol (suma, minimo, maximo, etc.), guardado en tamanio bytes.
+ * Identidad es el valor del agregado de un conjunto vacio.
+ * Extraer guarda en valor el agregado de un elemento repetido la
+ * cantidad de veces indicada (1 salvo en modo multiconjunto).
+ * Combinar guarda en resultado el agregado de a seguido de b; debe ser
+ * asociativa y admitir que resultado sea el mismo que a o b.
+ */
+typedef struct abb_agregado {
+	size_t tamanio;
+	const void* identidad;
+	void (*extraer)(void* elemento, size_t repeticiones, void* valor);
+	void (*combinar)(const void* a, const void* b, void* resultado);
+} abb_agregado_t;
 
 typedef struct nodo_abb {
 	void* elemento;
 	struct nodo_abb* izquierda;
 	struct nodo_abb* derecha;
+	size_t tamanio;
+	max_align_t opcionales[]; // Campos que dependen de la configuracion del arbol
 } nodo_abb_t;
 
+struct pool_nodos;
+
 typedef struct abb{
 	nodo_abb_t* nodo_raiz;
 	abb_comparador comparador;
 	abb_liberar_elemento destructor;
+	struct pool_nodos* pool;
+	bool autoajustable;
+	bool multiconjunto;
+	abb_agregado_t agregado;
+	abb_prefijo prefijo;
 } abb_t;
 
 /*
@@ -45,6 +93,18 @@ typedef struct abb{
  */
 abb_t* arbol_crear(abb_comparador comparador, abb_liberar_elemento destructor);
 
+/*
+ * Crea un arbol balanceado a partir de un vector de elementos ordenado
+ * de menor a mayor segun el comparador, en tiempo lineal.
+ * Comparador y destructor cumplen la misma funcion que en arbol_crear.
+ *
+ * Devuelve un puntero al arbol creado o NULL en caso de error o si el
+ * vector no esta ordenado. En caso de error los elementos no se
+ * destruyen.
+ */
+abb_t* arbol_crear_desde_ordenado(abb_comparador comparador, abb_liberar_elemento destructor,
+                                  void** elementos, size_t cantidad);
+
 /*
  * Inserta un elemento en el arbol.
  * Devuelve 0 si pudo insertar o -1 si no pudo.
@@ -52,6 +112,16 @@ abb_t* arbol_crear(abb_comparador comparador, abb_liberar_elemento destructor);
  */
  int arbol_insertar(abb_t* arbol, void* elemento);
 
+/*
+ * Inserta en el arbol todos los elementos de un vector ordenado de
+ * menor a mayor segun el comparador. Los elementos se intercalan con
+ * los del arbol y el arbol se reconstruye balanceado, en tiempo lineal
+ * respecto de la cantidad total de elementos.
+ * Devuelve 0 si pudo insertar o -1 si no pudo (o si el vector no esta
+ * ordenado), en cuyo caso el arbol queda como estaba.
+ */
+int arbol_insertar_ordenados(abb_t* arbol, void** elementos, size_t cantidad);
+
 /*
  * Busca en el arbol un elemento igual al provisto (utilizando la
  * funcion de comparación) y si lo encuentra lo quita del arbol.
@@ -61,6 +131,39 @@ abb_t* arbol_crear(abb_comparador comparador, abb_liberar_elemento destructor);
  */
 int arbol_borrar(abb_t* arbol, void* elemento);
 
+/*
+ * Divide el arbol en dos: en izquierda quedan los elementos menores al
+ * pivote y en derecha los mayores o iguales. Ambos arboles conservan la
+ * configuracion del original y comparten sus nodos, por lo que la
+ * division no copia elementos y toma tiempo proporcional a la altura.
+ * Las dos partes quedan balanceadas por peso (ninguna rama pesa mas de
+ * 5/2 veces su hermana) si el original lo estaba, y entonces la altura
+ * es O(log n), como en los arboles de arbol_crear_desde_ordenado,
+ * arbol_insertar_ordenados, arbol_cargar, arbol_dividir y arbol_unir.
+ * arbol_insertar y arbol_borrar no rebalancean.
+ * Si tiene exito, el arbol original deja de existir.
+ * Los dos arboles reservan sus nodos del mismo pool, que no es seguro
+ * entre hilos: no pueden modificarse desde hilos distintos a la vez.
+ * Devuelve 0 si pudo dividir o -1 si no pudo, en cuyo caso el arbol
+ * original queda intacto.
+ */
+int arbol_dividir(abb_t* arbol, void* pivote, abb_t** izquierda, abb_t** derecha);
+
+/*
+ * Une dos arboles con la misma configuracion, donde todos los elementos
+ * de izquierda son menores o iguales a los de derecha. El resultado
+ * queda en izquierda y derecha deja de existir. En modo multiconjunto,
+ * si el mayor de izquierda es igual al menor de derecha se suman sus
+ * repeticiones, se conserva el de izquierda y el de derecha se
+ * descarta. La union toma tiempo proporcional a la altura, salvo que
+ * derecha comparta su pool con un arbol distinto de izquierda, en cuyo
+ * caso se copian sus nodos. Si los dos arboles estan balanceados por
+ * peso (ver arbol_dividir), el resultado tambien lo esta.
+ * Devuelve 0 si pudo unir o -1 si no pudo, en cuyo caso ambos arboles
+ * quedan intactos.
+ */
+int arbol_unir(abb_t* izquierda, abb_t* derecha);
+
 /*
  * Busca en el arbol un elemento igual al provisto (utilizando la
  * funcion de comparación).
@@ -69,6 +172,52 @@ int arbol_borrar(abb_t* arbol, void* elemento);
  */
 void* arbol_buscar(abb_t* arbol, void* elemento);
 
+/*
+ * Activa o desactiva el modo autoajustable. En este modo cada busqueda
+ * lleva el elemento buscado (o el ultimo visitado, si no se encuentra)
+ * a la raiz mediante rotaciones (splay), de forma que los elementos
+ * accedidos con frecuencia quedan cerca de la raiz.
+ * En este modo arbol_buscar modifica la forma del arbol.
+ */
+void arbol_modo_autoajustable(abb_t* arbol, bool activar);
+
+/*
+ * Activa o desactiva el modo multiconjunto. Solo puede cambiarse con el
+ * arbol vacio. En este modo los elementos iguales no ocupan un nodo
+ * cada uno: el arbol conserva el primer elemento insertado y cuenta sus
+ * repeticiones. Al insertar un elemento igual a uno existente se suma
+ * una repeticion y el arbol toma posesion del elemento insertado, que
+ * se descarta destruyendolo en el momento, salvo que sea el mismo
+ * puntero que el conservado (por ejemplo, al contar un mismo elemento
+ * insertandolo varias veces). El elemento conservado nunca se destruye
+ * por un repetido. Al borrar se descuenta una repeticion, y el elemento
+ * conservado se destruye cuando se borra la ultima. Los recorridos
+ * visitan el elemento conservado una vez por cada repeticion.
+ * Devuelve 0 si pudo cambiar el modo o -1 si no pudo.
+ */
+int arbol_modo_multiconjunto(abb_t* arbol, bool activar);
+
+/*
+ * Define el agregado que cada nodo mantiene sobre los elementos de su
+ * subarbol, o lo quita si agregado es NULL. Si el arbol tiene elementos,
+ * sus nodos se copian y el agregado se calcula de abajo hacia arriba en
+ * tiempo lineal. El descriptor se copia, pero la identidad debe seguir
+ * existiendo mientras exista el arbol.
+ * Devuelve 0 si pudo definir el agregado o -1 si no pudo.
+ */
+int arbol_definir_agregado(abb_t* arbol, const abb_agregado_t* agregado);
+
+/*
+ * Define la funcion que calcula el prefijo de cada elemento, o la quita
+ * si prefijo es NULL. El prefijo se guarda en cada nodo y las busquedas
+ * comparan primero los prefijos, llamando al comparador solo cuando son
+ * iguales. Si el arbol tiene elementos, sus nodos se copian calculando
+ * el prefijo de cada uno; como el prefijo respeta el orden del
+ * comparador, la forma del arbol no cambia.
+ * Devuelve 0 si pudo definir el prefijo o -1 si no pudo.
+ */
+int arbol_definir_prefijo(abb_t* arbol, abb_prefijo prefijo);
+
 /*
  * Devuelve el elemento almacenado como raiz o NULL si el árbol está
  * vacío o no existe.
@@ -81,6 +230,37 @@ void* arbol_raiz(abb_t* arbol);
  */
 bool arbol_vacio(abb_t* arbol);
 
+/*
+ * Devuelve la cantidad de elementos almacenados en el arbol o 0 si el
+ * arbol no existe.
+ */
+size_t arbol_cantidad(abb_t* arbol);
+
+/*
+ * Devuelve el k-esimo elemento del arbol en orden, donde 0 es el
+ * menor elemento, o NULL si no existe dicha posicion.
+ */
+void* arbol_kesimo(abb_t* arbol, size_t k);
+
+/*
+ * Devuelve la cantidad de elementos del arbol que son menores al
+ * elemento provisto (utilizando la funcion de comparación), es decir,
+ * la posicion que ocuparia el elemento en un recorrido inorden.
+ * El elemento no necesita estar en el arbol.
+ */
+size_t arbol_rango_de(abb_t* arbol, void* elemento);
+
+/*
+ * Calcula el agregado de los elementos entre desde y hasta (incluidos),
+ * combinados de menor a mayor, y lo guarda en resultado. Desde o hasta
+ * pueden ser NULL, indicando que no hay limite de ese lado. Si no hay
+ * elementos en el rango, el resultado es la identidad. Toma tiempo
+ * proporcional a la altura del arbol.
+ * Devuelve 0 si pudo calcularlo o -1 en caso de error, o si el arbol no
+ * tiene agregado.
+ */
+int arbol_agregar_rango(abb_t* arbol, void* desde, void* hasta, void* resultado);
+
 /*
  * Llena el array del tamaño dado con los elementos de arbol
  * en secuencia inorden.
@@ -89,7 +269,7 @@ bool arbol_vacio(abb_t* arbol);
  * llena hasta donde puede y devuelve la cantidad de elementos que
  * pudo poner).
  */
-int arbol_recorrido_inorden(abb_t* arbol, void** array, int tamanio_array);
+size_t arbol_recorrido_inorden(abb_t* arbol, void** array, size_t tamanio_array);
 
 /*
  * Llena el array del tamaño dado con los elementos de arbol
@@ -99,7 +279,7 @@ int arbol_recorrido_inorden(abb_t* arbol, void** array, int tamanio_array);
  * llena hasta donde puede y devuelve la cantidad de elementos que
  * pudo poner).
  */
-int arbol_recorrido_preorden(abb_t* arbol, void** array, int tamanio_array);
+size_t arbol_recorrido_preorden(abb_t* arbol, void** array, size_t tamanio_array);
 
 /*
  * Llena el array del tamaño dado con los elementos de arbol
@@ -109,7 +289,23 @@ int arbol_recorrido_preorden(abb_t* arbol, void** array, int tamanio_array);
  * llena hasta donde puede y devuelve la cantidad de elementos que
  * pudo poner).
  */
-int arbol_recorrido_postorden(abb_t* arbol, void** array, int tamanio_array);
+size_t arbol_recorrido_postorden(abb_t* arbol, void** array, size_t tamanio_array);
+
+/*
+ * Llena el array del tamaño dado con la siguiente pagina de elementos
+ * del arbol en el recorrido solicitado, comenzando desde la posicion
+ * indicada por el cursor (0 para comenzar desde el principio). Al
+ * terminar, avanza el cursor hasta el primer elemento que no entro en
+ * el array, de forma que la siguiente llamada continue desde ahi.
+ * Los subarboles anteriores al cursor se saltean sin recorrerlos, por
+ * lo que obtener una pagina cuesta O(altura + tamanio_array).
+ * Los recorridos válidos son: ABB_RECORRER_INORDEN,
+ * ABB_RECORRER_PREORDEN y ABB_RECORRER_POSTORDEN.
+ * Devuelve la cantidad de elementos del array que pudo llenar. Una
+ * cantidad menor a tamanio_array indica que no quedan mas elementos.
+ */
+size_t arbol_recorrido_pagina(abb_t* arbol, int recorrido, size_t* cursor, void** array,
+                              size_t tamanio_array);
 
 /*
  * Destruye el arbol liberando la memoria reservada por el mismo.
@@ -118,6 +314,30 @@ int arbol_recorrido_postorden(abb_t* arbol, void** array, int tamanio_array);
  */
 void arbol_destruir(abb_t* arbol);
 
+/*
+ * Guarda el arbol en el archivo de la ruta dada, en un formato binario
+ * compacto: una cabecera con la cantidad de elementos, seguida de cada
+ * elemento en orden escrito con el serializador (y sus repeticiones si
+ * el arbol esta en modo multiconjunto).
+ * Devuelve 0 si pudo guardar o -1 si no pudo.
+ */
+int arbol_guardar(abb_t* arbol, const char* ruta, abb_serializar serializar);
+
+/*
+ * Crea un arbol con los elementos guardados con arbol_guardar en el
+ * archivo de la ruta dada, leyendo cada elemento con el deserializador.
+ * El arbol se reconstruye balanceado en tiempo lineal. La memoria se
+ * reserva a medida que se leen los elementos, no segun la cantidad que
+ * declara la cabecera, y un archivo con datos despues del ultimo
+ * elemento se rechaza.
+ * Comparador y destructor cumplen la misma funcion que en arbol_crear.
+ *
+ * Devuelve un puntero al arbol creado o NULL en caso de error. En caso
+ * de error, los elementos que se hayan leido se destruyen.
+ */
+abb_t* arbol_cargar(const char* ruta, abb_comparador comparador, abb_liberar_elemento destructor,
+                    abb_deserializar deserializar);
+
 /*
  * Iterador interno. Recorre el arbol e invoca la funcion con cada
  * elemento del mismo. El puntero 'extra' se pasa como segundo
@@ -0,0 +1,638 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "abb.h"
+#include "abb_concurrente.h"
+
+#define NIVEL_MAXIMO  32 // Alcanza para cualquier cantidad de elementos razonable
+#define EPOCAS        3  // Epocas distintas que pueden tener nodos retirados a la vez
+#define TAMANIO_LINEA 64 // Bytes de una linea de cache
+#define RANURA_LIBRE  0  // Valor de una ranura sin operacion anotada (las epocas empiezan en 1)
+
+typedef struct nodo_sl
+{
+    void*                     elemento;
+    pthread_mutex_t           cerrojo;
+    atomic_bool               marcado;  // Borrado logicamente, esta siendo desenlazado
+    atomic_bool               enlazado; // Enlazado en todos sus niveles
+    int                       niveles;
+    struct nodo_sl*           siguiente_retirado;
+    _Atomic(struct nodo_sl*) siguientes[];
+} nodo_sl_t;
+
+/*
+ * Ranura donde un hilo anota la epoca de la operacion que esta haciendo.
+ * Ocupa una linea de cache entera para que los hilos no se disputen la
+ * misma linea al entrar y salir de cada operacion. Las ranuras de un
+ * arbol forman una lista que solo crece: hay tantas como operaciones
+ * simultaneas llego a tener el arbol.
+ */
+typedef struct ranura
+{
+    _Alignas(TAMANIO_LINEA) atomic_size_t epoca;
+    struct ranura* siguiente; // No cambia despues de agregarse a la lista
+} ranura_t;
+
+struct abb_concurrente
+{
+    nodo_sl_t*           cabeza; // Centinela con todos los niveles y sin elemento
+    abb_comparador       comparador;
+    abb_liberar_elemento destructor;
+    atomic_size_t        cantidad;
+    atomic_int           niveles; // Ningun nodo tiene mas niveles, las busquedas empiezan ahi
+
+    // Liberacion diferida por epocas: cada operacion se anota en la epoca vigente y los nodos
+    // retirados en una epoca se liberan cuando ya no queda nadie anotado en ella.
+    atomic_size_t      epoca;
+    pthread_mutex_t    cerrojo_retirados;
+    nodo_sl_t*         retirados[EPOCAS];
+    _Atomic(ranura_t*) ranuras;
+    size_t             identificador; // Unico por arbol creado, aunque se reuse la memoria
+};
+
+/*
+ * Crea un nodo con la cantidad de niveles dada, sin enlazar.
+ *
+ * Devuelve NULL en caso de no poder crear.
+ */
+static nodo_sl_t* nuevo_nodo_sl(void* elemento, int niveles)
+{
+    nodo_sl_t* nodo = malloc(sizeof(nodo_sl_t) + (size_t)niveles * sizeof(nodo_sl_t*));
+    if (!nodo)
+        return NULL;
+    if (pthread_mutex_init(&nodo->cerrojo, NULL) != 0)
+    {
+        free(nodo);
+        return NULL;
+    }
+    nodo->elemento = elemento;
+    nodo->niveles = niveles;
+    nodo->siguiente_retirado = NULL;
+    atomic_init(&nodo->marcado, false);
+    atomic_init(&nodo->enlazado, false);
+    for (int i = 0; i < niveles; i++)
+        atomic_init(&nodo->siguientes[i], NULL);
+    return nodo;
+}
+
+/*
+ * Libera un nodo, utilizando el destructor en caso de existir.
+ */
+static void liberar_nodo_sl(nodo_sl_t* nodo, abb_liberar_elemento destructor)
+{
+    if (destructor)
+        destructor(nodo->elemento);
+    pthread_mutex_destroy(&nodo->cerrojo);
+    free(nodo);
+}
+
+/*
+ * Crea el arbol y reserva la memoria necesaria de la estructura.
+ * Comparador se utiliza para comparar dos elementos.
+ * Destructor es invocado sobre cada elemento que sale del arbol,
+ * puede ser NULL indicando que no se debe utilizar un destructor.
+ * El destructor puede ser invocado desde cualquiera de los hilos que
+ * borran elementos.
+ *
+ * Devuelve un puntero al arbol creado o NULL en caso de error.
+ */
+abb_concurrente_t* arbol_concurrente_crear(abb_comparador comparador,
+                                           abb_liberar_elemento destructor)
+{
+    if (!comparador)
+        return NULL;
+    abb_concurrente_t* arbol = calloc(1, sizeof(abb_concurrente_t));
+    if (!arbol)
+        return NULL;
+    arbol->cabeza = nuevo_nodo_sl(NULL, NIVEL_MAXIMO);
+    if (!arbol->cabeza)
+    {
+        free(arbol);
+        return NULL;
+    }
+    if (pthread_mutex_init(&arbol->cerrojo_retirados, NULL) != 0)
+    {
+        liberar_nodo_sl(arbol->cabeza, NULL);
+        free(arbol);
+        return NULL;
+    }
+    arbol->comparador = comparador;
+    arbol->destructor = destructor;
+    atomic_init(&arbol->cantidad, 0);
+    atomic_init(&arbol->niveles, 1);
+    atomic_init(&arbol->epoca, 1);
+    atomic_init(&arbol->ranuras, NULL);
+    static atomic_size_t arboles_creados = 0;
+    arbol->identificador = atomic_fetch_add_explicit(&arboles_creados, 1, memory_order_relaxed);
+    return arbol;
+}
+
+/*
+ * Ultima ranura que uso el hilo, junto con el arbol al que pertenece.
+ * Mientras el hilo use el mismo arbol, vuelve a intentar con la misma
+ * ranura y su linea de cache queda en el nucleo donde corre.
+ */
+static _Thread_local struct
+{
+    size_t    arbol;
+    ranura_t* ranura;
+} preferida = {SIZE_MAX, NULL};
+
+/*
+ * Intenta ocupar la ranura anotandola en la epoca dada.
+ * El intercambio ordena la anotacion antes de releer la epoca vigente:
+ * sin ese orden, quien retira podria no verla y liberar nodos alcanzables.
+ *
+ * Devuelve true si pudo ocuparla.
+ */
+static bool ocupar(ranura_t* ranura, size_t epoca)
+{
+    size_t libre = RANURA_LIBRE;
+    return atomic_compare_exchange_strong(&ranura->epoca, &libre, epoca);
+}
+
+/*
+ * Ocupa una ranura libre del arbol anotandola en la epoca dada. Si estan
+ * todas ocupadas, agrega una nueva a la lista, asi que nunca espera a
+ * que otro hilo libere la suya.
+ *
+ * Devuelve la ranura ocupada o NULL si no pudo crear una nueva.
+ */
+static ranura_t* ocupar_libre(abb_concurrente_t* arbol, size_t epoca)
+{
+    ranura_t* ranura = atomic_load(&arbol->ranuras);
+    for (; ranura; ranura = ranura->siguiente)
+        if (ocupar(ranura, epoca))
+            return ranura;
+    ranura = aligned_alloc(TAMANIO_LINEA, sizeof(ranura_t));
+    if (!ranura)
+        return NULL;
+    atomic_init(&ranura->epoca, epoca);
+    ranura->siguiente = atomic_load(&arbol->ranuras);
+    while (!atomic_compare_exchange_weak(&arbol->ranuras, &ranura->siguiente, ranura))
+        ;
+    return ranura;
+}
+
+/*
+ * Anota una operacion en la epoca vigente, ocupando la ultima ranura que
+ * uso el hilo en este arbol o, si no esta libre, cualquier otra. Mientras
+ * la operacion este anotada, ningun nodo que pueda alcanzar va a ser
+ * liberado. Nunca espera a otros hilos.
+ *
+ * Devuelve la ranura en la que quedo anotada, para pasarsela a salir, o
+ * NULL si no pudo anotarla.
+ */
+static ranura_t* entrar(abb_concurrente_t* arbol)
+{
+    ranura_t* ranura = preferida.arbol == arbol->identificador ? preferida.ranura : NULL;
+    while (true)
+    {
+        size_t epoca = atomic_load_explicit(&arbol->epoca, memory_order_acquire);
+        if (!ranura || !ocupar(ranura, epoca))
+            ranura = ocupar_libre(arbol, epoca);
+        if (!ranura)
+            return NULL;
+        // Si la epoca avanzo mientras se anotaba, se anota de nuevo en la vigente
+        if (atomic_load(&arbol->epoca) == epoca)
+            break;
+        atomic_store_explicit(&ranura->epoca, RANURA_LIBRE, memory_order_release);
+    }
+    preferida.arbol = arbol->identificador;
+    preferida.ranura = ranura;
+    return ranura;
+}
+
+/*
+ * Quita la anotacion de una operacion que termino.
+ */
+static void salir(ranura_t* ranura)
+{
+    atomic_store_explicit(&ranura->epoca, RANURA_LIBRE, memory_order_release);
+}
+
+/*
+ * Determina si todas las operaciones anotadas estan en la epoca dada.
+ */
+static bool todas_en_epoca(abb_concurrente_t* arbol, size_t epoca)
+{
+    for (ranura_t* ranura = atomic_load(&arbol->ranuras); ranura; ranura = ranura->siguiente)
+    {
+        size_t anotada = atomic_load(&ranura->epoca);
+        if (anotada != RANURA_LIBRE && anotada != epoca)
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Libera una cadena de nodos retirados.
+ */
+static void liberar_retirados(nodo_sl_t* nodo, abb_liberar_elemento destructor)
+{
+    while (nodo)
+    {
+        nodo_sl_t* siguiente = nodo->siguiente_retirado;
+        liberar_nodo_sl(nodo, destructor);
+        nodo = siguiente;
+    }
+}
+
+/*
+ * Retira un nodo ya desenlazado. El nodo se guarda junto a los demas
+ * retirados en la epoca vigente, y si todas las operaciones anotadas
+ * estan en la epoca vigente se avanza de epoca y se liberan los nodos
+ * que se retiraron en la anterior: ya nadie puede tener una referencia
+ * a los mismos.
+ * Quien retira no debe estar anotado en ninguna epoca.
+ */
+static void retirar(abb_concurrente_t* arbol, nodo_sl_t* nodo)
+{
+    nodo_sl_t* a_liberar = NULL;
+    pthread_mutex_lock(&arbol->cerrojo_retirados);
+    size_t epoca = atomic_load(&arbol->epoca);
+    nodo->siguiente_retirado = arbol->retirados[epoca % EPOCAS];
+    arbol->retirados[epoca % EPOCAS] = nodo;
+    size_t anterior = (epoca + EPOCAS - 1) % EPOCAS;
+    if (todas_en_epoca(arbol, epoca))
+    {
+        a_liberar = arbol->retirados[anterior];
+        arbol->retirados[anterior] = NULL;
+        atomic_store(&arbol->epoca, epoca + 1);
+    }
+    pthread_mutex_unlock(&arbol->cerrojo_retirados);
+    liberar_retirados(a_liberar, arbol->destructor);
+}
+
+/*
+ * Devuelve una cantidad de niveles al azar para un nodo nuevo, donde
+ * cada nivel extra tiene la mitad de probabilidad que el anterior.
+ */
+static int niveles_al_azar(void)
+{
+    static _Thread_local uint64_t estado = 0;
+    if (!estado)
+        estado = (uint64_t)(uintptr_t)&estado | 1;
+    // xorshift64
+    estado ^= estado << 13;
+    estado ^= estado >> 7;
+    estado ^= estado << 17;
+    uint64_t bits = estado;
+    int      niveles = 1;
+    while (niveles < NIVEL_MAXIMO && (bits & 1))
+    {
+        niveles++;
+        bits >>= 1;
+    }
+    return niveles;
+}
+
+/*
+ * Devuelve la cantidad de niveles en uso del arbol.
+ */
+static int niveles_en_uso(abb_concurrente_t* arbol)
+{
+    return atomic_load_explicit(&arbol->niveles, memory_order_acquire);
+}
+
+/*
+ * Sube la cantidad de niveles en uso del arbol, si es menor a la dada.
+ * Se llama antes de enlazar un nodo con esa cantidad de niveles.
+ */
+static void subir_niveles(abb_concurrente_t* arbol, int niveles)
+{
+    int actual = niveles_en_uso(arbol);
+    while (actual < niveles &&
+           !atomic_compare_exchange_weak_explicit(&arbol->niveles, &actual, niveles,
+                                                  memory_order_acq_rel, memory_order_acquire))
+        ;
+}
+
+/*
+ * Busca la posicion del elemento en los primeros niveles dados, sin
+ * tomar locks. Guarda en predecesores y sucesores los nodos entre los
+ * que quedaria el elemento en cada uno de esos niveles.
+ *
+ * Devuelve el nivel mas alto en el que se encontro un nodo igual al
+ * elemento, o -1 si no se encontro.
+ */
+static int buscar_posicion(abb_concurrente_t* arbol, void* elemento, int niveles,
+                           nodo_sl_t** predecesores, nodo_sl_t** sucesores)
+{
+    int        encontrado = -1;
+    nodo_sl_t* predecesor = arbol->cabeza;
+    for (int nivel = niveles - 1; nivel >= 0; nivel--)
+    {
+        nodo_sl_t* actual = atomic_load_explicit(&predecesor->siguientes[nivel], memory_order_acquire);
+        int        comparacion = 1;
+        while (actual && (comparacion = arbol->comparador(actual->elemento, elemento)) < 0)
+        {
+            predecesor = actual;
+            actual = atomic_load_explicit(&predecesor->siguientes[nivel], memory_order_acquire);
+        }
+        if (encontrado == -1 && actual && comparacion == 0)
+            encontrado = nivel;
+        predecesores[nivel] = predecesor;
+        sucesores[nivel] = actual;
+    }
+    return encontrado;
+}
+
+static bool esta_marcado(nodo_sl_t* nodo)
+{
+    return atomic_load_explicit(&nodo->marcado, memory_order_acquire);
+}
+
+static bool esta_enlazado(nodo_sl_t* nodo)
+{
+    return atomic_load_explicit(&nodo->enlazado, memory_order_acquire);
+}
+
+/*
+ * Toma el lock de los predecesores de los primeros niveles dados, de
+ * abajo hacia arriba (de derecha a izquierda en la lista) y sin tomar
+ * dos veces el mismo nodo, validando que sigan siendo predecesores
+ * validos (no borrados y apuntando al sucesor esperado).
+ * Si sucesor_unico no es NULL, se espera ese sucesor en todos los
+ * niveles; si no, el de sucesores.
+ * Guarda en bloqueados la cantidad de niveles cuyo lock se tomo, que
+ * deben liberarse con desbloquear_predecesores.
+ *
+ * Devuelve true si la validacion fue exitosa, false en caso contrario.
+ */
+static bool bloquear_predecesores(nodo_sl_t** predecesores, nodo_sl_t** sucesores,
+                                  nodo_sl_t* sucesor_unico, int niveles, int* bloqueados)
+{
+    nodo_sl_t* anterior = NULL;
+    for (int nivel = 0; nivel < niveles; nivel++)
+    {
+        nodo_sl_t* predecesor = predecesores[nivel];
+        nodo_sl_t* sucesor = sucesor_unico ? sucesor_unico : sucesores[nivel];
+        if (predecesor != anterior)
+        {
+            pthread_mutex_lock(&predecesor->cerrojo);
+            anterior = predecesor;
+        }
+        *bloqueados = nivel + 1;
+        bool valido = !esta_marcado(predecesor) &&
+                      atomic_load_explicit(&predecesor->siguientes[nivel], memory_order_acquire) ==
+                          sucesor &&
+                      (sucesor_unico || !sucesor || !esta_marcado(sucesor));
+        if (!valido)
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Libera el lock de los predecesores de los primeros niveles dados.
+ */
+static void desbloquear_predecesores(nodo_sl_t** predecesores, int niveles)
+{
+    nodo_sl_t* anterior = NULL;
+    for (int nivel = 0; nivel < niveles; nivel++)
+        if (predecesores[nivel] != anterior)
+        {
+            anterior = predecesores[nivel];
+            pthread_mutex_unlock(&anterior->cerrojo);
+        }
+}
+
+/*
+ * Inserta un elemento en el arbol.
+ * Devuelve 0 si pudo insertar o -1 si no pudo (o si ya existia un
+ * elemento igual).
+ */
+int arbol_concurrente_insertar(abb_concurrente_t* arbol, void* elemento)
+{
+    if (!arbol)
+        return -1;
+    nodo_sl_t* nuevo = nuevo_nodo_sl(elemento, niveles_al_azar());
+    if (!nuevo)
+        return -1;
+    nodo_sl_t* predecesores[NIVEL_MAXIMO];
+    nodo_sl_t* sucesores[NIVEL_MAXIMO];
+    ranura_t*  ranura = entrar(arbol);
+    if (!ranura)
+    {
+        liberar_nodo_sl(nuevo, NULL);
+        return -1;
+    }
+    subir_niveles(arbol, nuevo->niveles);
+    int niveles = niveles_en_uso(arbol);
+    while (true)
+    {
+        int encontrado = buscar_posicion(arbol, elemento, niveles, predecesores, sucesores);
+        if (encontrado != -1)
+        {
+            nodo_sl_t* existente = sucesores[encontrado];
+            // Si el igual esta siendo borrado, se reintenta hasta que termine de desenlazarse
+            if (esta_marcado(existente))
+                continue;
+            while (!esta_enlazado(existente))
+                ;
+            salir(ranura);
+            liberar_nodo_sl(nuevo, NULL);
+            return -1;
+        }
+        int bloqueados = 0;
+        if (!bloquear_predecesores(predecesores, sucesores, NULL, nuevo->niveles, &bloqueados))
+        {
+            desbloquear_predecesores(predecesores, bloqueados);
+            continue;
+        }
+        for (int nivel = 0; nivel < nuevo->niveles; nivel++)
+            atomic_store_explicit(&nuevo->siguientes[nivel], sucesores[nivel], memory_order_relaxed);
+        for (int nivel = 0; nivel < nuevo->niveles; nivel++)
+            atomic_store_explicit(&predecesores[nivel]->siguientes[nivel], nuevo,
+                                  memory_order_release);
+        atomic_store_explicit(&nuevo->enlazado, true, memory_order_release);
+        desbloquear_predecesores(predecesores, bloqueados);
+        atomic_fetch_add(&arbol->cantidad, 1);
+        salir(ranura);
+        return 0;
+    }
+}
+
+/*
+ * Determina si el nodo encontrado por buscar_posicion puede borrarse:
+ * tiene que estar completamente enlazado, haberse encontrado en su
+ * nivel mas alto y no estar siendo borrado por otro hilo.
+ */
+static bool puede_borrarse(nodo_sl_t* nodo, int nivel_encontrado)
+{
+    return esta_enlazado(nodo) && nodo->niveles - 1 == nivel_encontrado && !esta_marcado(nodo);
+}
+
+/*
+ * Busca en el arbol un elemento igual al provisto (utilizando la
+ * funcion de comparación) y si lo encuentra lo quita del arbol.
+ * El destructor se invoca con dicho elemento una vez que ningun otro
+ * hilo puede estar accediendo al nodo que lo contenia.
+ * Devuelve 0 si pudo eliminar el elemento o -1 en caso contrario.
+ */
+int arbol_concurrente_borrar(abb_concurrente_t* arbol, void* elemento)
+{
+    if (!arbol)
+        return -1;
+    nodo_sl_t* predecesores[NIVEL_MAXIMO];
+    nodo_sl_t* sucesores[NIVEL_MAXIMO];
+    nodo_sl_t* victima = NULL;
+    ranura_t*  ranura = entrar(arbol);
+    if (!ranura)
+        return -1;
+    int niveles = niveles_en_uso(arbol);
+    while (true)
+    {
+        int encontrado = buscar_posicion(arbol, elemento, niveles, predecesores, sucesores);
+        if (!victima)
+        {
+            // Si tiene mas niveles de los leidos al empezar, se busca desde su nivel mas alto
+            if (encontrado != -1 && sucesores[encontrado]->niveles > niveles)
+            {
+                niveles = sucesores[encontrado]->niveles;
+                continue;
+            }
+            if (encontrado == -1 || !puede_borrarse(sucesores[encontrado], encontrado))
+            {
+                salir(ranura);
+                return -1;
+            }
+            // Se marca la victima con su lock tomado: a partir de aca nadie inserta despues de
+            // ella y ningun otro hilo puede borrarla.
+            nodo_sl_t* candidata = sucesores[encontrado];
+            pthread_mutex_lock(&candidata->cerrojo);
+            if (esta_marcado(candidata))
+            {
+                pthread_mutex_unlock(&candidata->cerrojo);
+                salir(ranura);
+                return -1;
+            }
+            atomic_store_explicit(&candidata->marcado, true, memory_order_release);
+            victima = candidata;
+        }
+        int bloqueados = 0;
+        if (!bloquear_predecesores(predecesores, NULL, victima, victima->niveles, &bloqueados))
+        {
+            desbloquear_predecesores(predecesores, bloqueados);
+            continue;
+        }
+        for (int nivel = victima->niveles - 1; nivel >= 0; nivel--)
+            atomic_store_explicit(
+                &predecesores[nivel]->siguientes[nivel],
+                atomic_load_explicit(&victima->siguientes[nivel], memory_order_relaxed),
+                memory_order_release);
+        pthread_mutex_unlock(&victima->cerrojo);
+        desbloquear_predecesores(predecesores, bloqueados);
+        atomic_fetch_sub(&arbol->cantidad, 1);
+        salir(ranura);
+        retirar(arbol, victima);
+        return 0;
+    }
+}
+
+/*
+ * Busca en el arbol un elemento igual al provisto (utilizando la
+ * funcion de comparación). Nunca se bloquea.
+ *
+ * Devuelve el elemento encontrado o NULL si no lo encuentra (o si no
+ * pudo reservar memoria para anotar la busqueda).
+ */
+void* arbol_concurrente_buscar(abb_concurrente_t* arbol, void* elemento)
+{
+    if (!arbol || !elemento)
+        return NULL;
+    nodo_sl_t* predecesores[NIVEL_MAXIMO];
+    nodo_sl_t* sucesores[NIVEL_MAXIMO];
+    ranura_t*  ranura = entrar(arbol);
+    if (!ranura)
+        return NULL;
+    void*      resultado = NULL;
+    int        niveles = niveles_en_uso(arbol);
+    int        encontrado = buscar_posicion(arbol, elemento, niveles, predecesores, sucesores);
+    if (encontrado != -1 && esta_enlazado(sucesores[encontrado]) &&
+        !esta_marcado(sucesores[encontrado]))
+        resultado = sucesores[encontrado]->elemento;
+    salir(ranura);
+    return resultado;
+}
+
+/*
+ * Devuelve la cantidad de elementos almacenados en el arbol o 0 si el
+ * arbol no existe.
+ */
+size_t arbol_concurrente_cantidad(abb_concurrente_t* arbol)
+{
+    if (!arbol)
+        return 0;
+    return atomic_load(&arbol->cantidad);
+}
+
+/*
+ * Determina si el árbol está vacío.
+ * Devuelve true si está vacío o el arbol es NULL, false si el árbol tiene elementos.
+ */
+bool arbol_concurrente_vacio(abb_concurrente_t* arbol)
+{
+    return arbol_concurrente_cantidad(arbol) == 0;
+}
+
+/*
+ * Iterador interno. Recorre el arbol en orden e invoca la funcion con
+ * cada elemento del mismo. El puntero 'extra' se pasa como segundo
+ * parámetro a la función. Si la función devuelve true, se finaliza el
+ * recorrido aun si quedan elementos por recorrer.
+ * Los elementos insertados o borrados durante el recorrido pueden o no
+ * ser visitados.
+ */
+void abb_concurrente_con_cada_elemento(abb_concurrente_t* arbol, bool (*funcion)(void*, void*),
+                                       void* extra)
+{
+    if (!arbol || !funcion)
+        return;
+    ranura_t* ranura = entrar(arbol);
+    if (!ranura)
+        return;
+    nodo_sl_t* actual = atomic_load_explicit(&arbol->cabeza->siguientes[0], memory_order_acquire);
+    while (actual)
+    {
+        if (esta_enlazado(actual) && !esta_marcado(actual) && funcion(actual->elemento, extra))
+            break;
+        actual = atomic_load_explicit(&actual->siguientes[0], memory_order_acquire);
+    }
+    salir(ranura);
+}
+
+/*
+ * Destruye el arbol liberando la memoria reservada por el mismo.
+ * Adicionalmente invoca el destructor con cada elemento presente en
+ * el arbol. Ningun otro hilo puede estar usando el arbol.
+ */
+void arbol_concurrente_destruir(abb_concurrente_t* arbol)
+{
+    if (!arbol)
+        return;
+    nodo_sl_t* actual = atomic_load(&arbol->cabeza->siguientes[0]);
+    while (actual)
+    {
+        nodo_sl_t* siguiente = atomic_load(&actual->siguientes[0]);
+        liberar_nodo_sl(actual, arbol->destructor);
+        actual = siguiente;
+    }
+    for (int i = 0; i < EPOCAS; i++)
+        liberar_retirados(arbol->retirados[i], arbol->destructor);
+    liberar_nodo_sl(arbol->cabeza, NULL);
+    ranura_t* ranura = atomic_load(&arbol->ranuras);
+    while (ranura)
+    {
+        ranura_t* siguiente = ranura->siguiente;
+        free(ranura);
+        ranura = siguiente;
+    }
+    pthread_mutex_destroy(&arbol->cerrojo_retirados);
+    free(arbol);
+}
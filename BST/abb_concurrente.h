@@ -0,0 +1,91 @@
+#ifndef __ABB_CONCURRENTE_H__
+#define __ABB_CONCURRENTE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "abb.h"
+
+/*
+ * Conjunto ordenado que puede ser usado desde varios hilos a la vez,
+ * con la misma semantica que abb.h. Internamente es una skip list
+ * "perezosa": las busquedas nunca toman locks y las inserciones y
+ * borrados solo bloquean los nodos vecinos al elemento, por lo que
+ * operaciones sobre rangos de claves distintos avanzan en paralelo.
+ *
+ * A diferencia de abb_t, no admite elementos repetidos.
+ *
+ * Los nodos borrados se liberan (e invocan al destructor) recien
+ * cuando ninguna operacion en curso puede estar usandolos.
+ */
+typedef struct abb_concurrente abb_concurrente_t;
+
+/*
+ * Crea el arbol y reserva la memoria necesaria de la estructura.
+ * Comparador se utiliza para comparar dos elementos.
+ * Destructor es invocado sobre cada elemento que sale del arbol,
+ * puede ser NULL indicando que no se debe utilizar un destructor.
+ * El destructor puede ser invocado desde cualquiera de los hilos que
+ * borran elementos.
+ *
+ * Devuelve un puntero al arbol creado o NULL en caso de error.
+ */
+abb_concurrente_t* arbol_concurrente_crear(abb_comparador comparador,
+                                           abb_liberar_elemento destructor);
+
+/*
+ * Inserta un elemento en el arbol.
+ * Devuelve 0 si pudo insertar o -1 si no pudo (o si ya existia un
+ * elemento igual).
+ */
+int arbol_concurrente_insertar(abb_concurrente_t* arbol, void* elemento);
+
+/*
+ * Busca en el arbol un elemento igual al provisto (utilizando la
+ * funcion de comparación) y si lo encuentra lo quita del arbol.
+ * El destructor se invoca con dicho elemento una vez que ningun otro
+ * hilo puede estar accediendo al nodo que lo contenia.
+ * Devuelve 0 si pudo eliminar el elemento o -1 en caso contrario.
+ */
+int arbol_concurrente_borrar(abb_concurrente_t* arbol, void* elemento);
+
+/*
+ * Busca en el arbol un elemento igual al provisto (utilizando la
+ * funcion de comparación). Nunca se bloquea.
+ *
+ * Devuelve el elemento encontrado o NULL si no lo encuentra (o si no
+ * pudo reservar memoria para anotar la busqueda).
+ */
+void* arbol_concurrente_buscar(abb_concurrente_t* arbol, void* elemento);
+
+/*
+ * Devuelve la cantidad de elementos almacenados en el arbol o 0 si el
+ * arbol no existe.
+ */
+size_t arbol_concurrente_cantidad(abb_concurrente_t* arbol);
+
+/*
+ * Determina si el árbol está vacío.
+ * Devuelve true si está vacío o el arbol es NULL, false si el árbol tiene elementos.
+ */
+bool arbol_concurrente_vacio(abb_concurrente_t* arbol);
+
+/*
+ * Iterador interno. Recorre el arbol en orden e invoca la funcion con
+ * cada elemento del mismo. El puntero 'extra' se pasa como segundo
+ * parámetro a la función. Si la función devuelve true, se finaliza el
+ * recorrido aun si quedan elementos por recorrer.
+ * Los elementos insertados o borrados durante el recorrido pueden o no
+ * ser visitados.
+ */
+void abb_concurrente_con_cada_elemento(abb_concurrente_t* arbol, bool (*funcion)(void*, void*),
+                                       void* extra);
+
+/*
+ * Destruye el arbol liberando la memoria reservada por el mismo.
+ * Adicionalmente invoca el destructor con cada elemento presente en
+ * el arbol. Ningun otro hilo puede estar usando el arbol.
+ */
+void arbol_concurrente_destruir(abb_concurrente_t* arbol);
+
+#endif /* __ABB_CONCURRENTE_H__ */
@@ -0,0 +1,157 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "abb.h"
+#include "abb_congelado.h"
+
+// Cantidad de niveles que se adelanta la precarga en la busqueda. Con 4 niveles, los 16
+// candidatos ocupan posiciones contiguas del vector (2 lineas de cache de 64 bytes).
+#define NIVELES_PRECARGA 4
+
+struct abb_congelado
+{
+    void**         elementos; // Indexado desde 1, la posicion 0 no se usa
+    size_t         cantidad;
+    abb_comparador comparador;
+};
+
+/*
+ * Ubica recursivamente los elementos ordenados en orden de Eytzinger.
+ * La posicion k tiene como hijos a 2k y 2k+1, asi que recorrer las
+ * posiciones en inorden consume los elementos ordenados en orden.
+ */
+static void ubicar(void** destino, size_t cantidad, void** ordenados, size_t* siguiente, size_t k)
+{
+    if (k > cantidad)
+        return;
+    ubicar(destino, cantidad, ordenados, siguiente, 2 * k);
+    destino[k] = ordenados[(*siguiente)++];
+    ubicar(destino, cantidad, ordenados, siguiente, 2 * k + 1);
+}
+
+/*
+ * Crea una copia inmutable del arbol dado.
+ *
+ * Devuelve un puntero a la copia o NULL en caso de error.
+ */
+abb_congelado_t* arbol_congelar(abb_t* arbol)
+{
+    if (!arbol)
+        return NULL;
+    abb_congelado_t* congelado = calloc(1, sizeof(abb_congelado_t));
+    if (!congelado)
+        return NULL;
+    congelado->comparador = arbol->comparador;
+    congelado->cantidad = arbol_cantidad(arbol);
+    congelado->elementos = malloc((congelado->cantidad + 1) * sizeof(void*));
+    void** ordenados = malloc((congelado->cantidad + 1) * sizeof(void*));
+    if (!congelado->elementos || !ordenados)
+    {
+        free(ordenados);
+        arbol_congelado_destruir(congelado);
+        return NULL;
+    }
+    size_t cantidad = arbol_recorrido_inorden(arbol, ordenados, congelado->cantidad);
+    size_t siguiente = 0;
+    congelado->elementos[0] = NULL;
+    ubicar(congelado->elementos, cantidad, ordenados, &siguiente, 1);
+    free(ordenados);
+    return congelado;
+}
+
+/*
+ * Dada la posicion en la que termino el descenso, deshace los ultimos
+ * pasos a la derecha y uno a la izquierda, quedando en el primer
+ * elemento que no es menor al buscado (0 si no hay ninguno).
+ */
+static size_t deshacer_descenso(size_t k)
+{
+#ifdef __GNUC__
+    return k >> (__builtin_ctzll(~(unsigned long long)k) + 1);
+#else
+    while (k & 1)
+        k >>= 1;
+    return k >> 1;
+#endif
+}
+
+/*
+ * Busca en la copia un elemento igual al provisto (utilizando la
+ * funcion de comparación del arbol original).
+ *
+ * Devuelve el elemento encontrado o NULL si no lo encuentra.
+ */
+void* arbol_congelado_buscar(abb_congelado_t* congelado, void* elemento)
+{
+    if (!congelado || !elemento)
+        return NULL;
+    void** elementos = congelado->elementos;
+    size_t cantidad = congelado->cantidad;
+    size_t k = 1;
+    // El descenso no tiene saltos condicionales: el resultado de la comparacion decide el hijo
+    while (k <= cantidad)
+    {
+#ifdef __GNUC__
+        if (k << NIVELES_PRECARGA <= cantidad)
+            __builtin_prefetch(elementos + (k << NIVELES_PRECARGA));
+#endif
+        k = 2 * k + (congelado->comparador(elementos[k], elemento) < 0);
+    }
+    k = deshacer_descenso(k);
+    if (k && congelado->comparador(elementos[k], elemento) == 0)
+        return elementos[k];
+    return NULL;
+}
+
+/*
+ * Devuelve la cantidad de elementos de la copia o 0 si no existe.
+ */
+size_t arbol_congelado_cantidad(abb_congelado_t* congelado)
+{
+    if (!congelado)
+        return 0;
+    return congelado->cantidad;
+}
+
+/*
+ * Recorrido inorden sobre las posiciones de Eytzinger.
+ * Deja de recorrer cuando la funcion devuelva true
+ */
+static bool congelado_inorden(abb_congelado_t* congelado, size_t k, bool (*funcion)(void*, void*),
+                              void* extra)
+{
+    if (k > congelado->cantidad)
+        return false;
+    if (congelado_inorden(congelado, 2 * k, funcion, extra))
+        return true;
+    if (funcion(congelado->elementos[k], extra))
+        return true;
+    return congelado_inorden(congelado, 2 * k + 1, funcion, extra);
+}
+
+/*
+ * Iterador interno. Recorre la copia en orden (de menor a mayor) e
+ * invoca la funcion con cada elemento. El puntero 'extra' se pasa como
+ * segundo parámetro a la función. Si la función devuelve true, se
+ * finaliza el recorrido aun si quedan elementos por recorrer.
+ */
+void arbol_congelado_con_cada_elemento(abb_congelado_t* congelado, bool (*funcion)(void*, void*),
+                                       void* extra)
+{
+    if (!congelado || !funcion)
+        return;
+    congelado_inorden(congelado, 1, funcion, extra);
+}
+
+/*
+ * Libera la memoria reservada por la copia. No invoca ningun destructor
+ * sobre los elementos.
+ */
+void arbol_congelado_destruir(abb_congelado_t* congelado)
+{
+    if (!congelado)
+        return;
+    free(congelado->elementos);
+    free(congelado);
+}
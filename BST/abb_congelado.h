@@ -0,0 +1,56 @@
+#ifndef __ABB_CONGELADO_H__
+#define __ABB_CONGELADO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "abb.h"
+
+/*
+ * Copia inmutable de un arbol, pensada para arboles que se construyen
+ * una vez y se consultan muchas veces. Los elementos se guardan en un
+ * unico vector contiguo en orden de Eytzinger (el orden de un recorrido
+ * por niveles de un arbol completo), lo que permite buscar sin seguir
+ * punteros entre nodos.
+ *
+ * La copia no es dueña de los elementos: siguen perteneciendo al arbol
+ * original y son validos mientras no salgan del mismo.
+ */
+typedef struct abb_congelado abb_congelado_t;
+
+/*
+ * Crea una copia inmutable del arbol dado.
+ *
+ * Devuelve un puntero a la copia o NULL en caso de error.
+ */
+abb_congelado_t* arbol_congelar(abb_t* arbol);
+
+/*
+ * Busca en la copia un elemento igual al provisto (utilizando la
+ * funcion de comparación del arbol original).
+ *
+ * Devuelve el elemento encontrado o NULL si no lo encuentra.
+ */
+void* arbol_congelado_buscar(abb_congelado_t* congelado, void* elemento);
+
+/*
+ * Devuelve la cantidad de elementos de la copia o 0 si no existe.
+ */
+size_t arbol_congelado_cantidad(abb_congelado_t* congelado);
+
+/*
+ * Iterador interno. Recorre la copia en orden (de menor a mayor) e
+ * invoca la funcion con cada elemento. El puntero 'extra' se pasa como
+ * segundo parámetro a la función. Si la función devuelve true, se
+ * finaliza el recorrido aun si quedan elementos por recorrer.
+ */
+void arbol_congelado_con_cada_elemento(abb_congelado_t* congelado, bool (*funcion)(void*, void*),
+                                       void* extra);
+
+/*
+ * Libera la memoria reservada por la copia. No invoca ningun destructor
+ * sobre los elementos.
+ */
+void arbol_congelado_destruir(abb_congelado_t* congelado);
+
+#endif /* __ABB_CONGELADO_H__ */
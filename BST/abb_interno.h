@@ -0,0 +1,58 @@
+#ifndef __ABB_INTERNO_H__
+#define __ABB_INTERNO_H__
+
+#include <stddef.h>
+#include <string.h>
+
+#include "abb.h"
+
+/*
+ * Detalles internos de abb_t compartidos por abb.c y abb_paralelo.c.
+ * No forman parte de la interfaz del arbol.
+ *
+ * Despues de los campos fijos, cada nodo tiene en opcionales solo los
+ * campos que usa la configuracion de su arbol: las repeticiones en modo
+ * multiconjunto, el prefijo si hay funcion de prefijo y el agregado del
+ * subarbol si hay uno definido, en ese orden.
+ */
+
+/*
+ * Devuelve la cantidad de elementos del subarbol (contando las
+ * repeticiones), 0 si el nodo es NULL.
+ */
+static inline size_t tamanio(nodo_abb_t* nodo)
+{
+    if (!nodo)
+        return 0;
+    return nodo->tamanio;
+}
+
+/*
+ * Devuelve las repeticiones del elemento del nodo (1 salvo en modo
+ * multiconjunto).
+ */
+static inline size_t repeticiones_de(abb_t* arbol, nodo_abb_t* nodo)
+{
+    size_t repeticiones = 1;
+    if (arbol->multiconjunto)
+        memcpy(&repeticiones, nodo->opcionales, sizeof(repeticiones));
+    return repeticiones;
+}
+
+/*
+ * Destruccion recursiva de los elementos.
+ *
+ * Se recorren los nodos en postorden, invocando el destructor con
+ * cada elemento. Los nodos no se liberan uno por uno, ya que la
+ * memoria se devuelve junto con el pool.
+ */
+static inline void destruir_elementos(nodo_abb_t* nodo, abb_liberar_elemento destructor)
+{
+    if (!nodo)
+        return;
+    destruir_elementos(nodo->izquierda, destructor);
+    destruir_elementos(nodo->derecha, destructor);
+    destructor(nodo->elemento);
+}
+
+#endif /* __ABB_INTERNO_H__ */
@@ -0,0 +1,245 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "abb.h"
+#include "abb_interno.h"
+#include "abb_paralelo.h"
+
+#define TAREAS_POR_HILO 8 // Mas tareas que hilos, para repartir bien subarboles desparejos
+
+/*
+ * Una tarea es un subarbol entero o, para los nodos que quedaron por
+ * encima de los subarboles repartidos, un nodo suelto.
+ */
+typedef struct tarea
+{
+    nodo_abb_t* nodo;
+    bool        solo_nodo;
+} tarea_t;
+
+typedef struct reparto
+{
+    tarea_t*      tareas;
+    size_t        cantidad;
+    atomic_size_t siguiente; // Proxima tarea sin tomar, los hilos toman de a una
+    atomic_bool   cortar;
+
+    abb_t* arbol;
+    int    recorrido;
+    bool (*funcion)(void*, void*);
+    void*                extra;
+    abb_liberar_elemento destructor;
+} reparto_t;
+
+/*
+ * Parte el arbol en tareas, dividiendo siempre el subarbol mas grande
+ * en sus dos hijos (y el nodo suelto) hasta tener la cantidad buscada
+ * o no poder dividir mas.
+ *
+ * Devuelve la cantidad de tareas o 0 en caso de error.
+ */
+static size_t repartir(nodo_abb_t* raiz, size_t buscadas, tarea_t** tareas)
+{
+    // Cada division agrega a lo sumo dos tareas
+    *tareas = malloc((buscadas + 2) * sizeof(tarea_t));
+    if (!*tareas)
+        return 0;
+    size_t cantidad = 0;
+    (*tareas)[cantidad++] = (tarea_t){raiz, false};
+    while (cantidad < buscadas)
+    {
+        size_t mayor = cantidad;
+        for (size_t i = 0; i < cantidad; i++)
+        {
+            nodo_abb_t* nodo = (*tareas)[i].nodo;
+            if ((*tareas)[i].solo_nodo || (!nodo->izquierda && !nodo->derecha))
+                continue;
+            if (mayor == cantidad || tamanio(nodo) > tamanio((*tareas)[mayor].nodo))
+                mayor = i;
+        }
+        if (mayor == cantidad)
+            break;
+        nodo_abb_t* nodo = (*tareas)[mayor].nodo;
+        (*tareas)[mayor].solo_nodo = true;
+        if (nodo->izquierda)
+            (*tareas)[cantidad++] = (tarea_t){nodo->izquierda, false};
+        if (nodo->derecha)
+            (*tareas)[cantidad++] = (tarea_t){nodo->derecha, false};
+    }
+    return cantidad;
+}
+
+/*
+ * Invoca la funcion con el elemento del nodo una vez por cada repeticion.
+ * Devuelve true si la funcion pidio cortar el recorrido.
+ */
+static bool visitar(reparto_t* reparto, nodo_abb_t* nodo)
+{
+    for (size_t i = 0; i < repeticiones_de(reparto->arbol, nodo); i++)
+        if (reparto->funcion(nodo->elemento, reparto->extra))
+            return true;
+    return false;
+}
+
+/*
+ * Recorre el subarbol en el orden pedido. Deja de recorrer cuando
+ * algun hilo pidio cortar el recorrido.
+ * Devuelve true si el recorrido se corto.
+ */
+static bool recorrer(reparto_t* reparto, nodo_abb_t* nodo)
+{
+    if (!nodo)
+        return false;
+    if (atomic_load_explicit(&reparto->cortar, memory_order_relaxed))
+        return true;
+    int recorrido = reparto->recorrido;
+    if (recorrido == ABB_RECORRER_PREORDEN && visitar(reparto, nodo))
+        return true;
+    if (recorrer(reparto, nodo->izquierda))
+        return true;
+    if (recorrido == ABB_RECORRER_INORDEN && visitar(reparto, nodo))
+        return true;
+    if (recorrer(reparto, nodo->derecha))
+        return true;
+    if (recorrido == ABB_RECORRER_POSTORDEN && visitar(reparto, nodo))
+        return true;
+    return false;
+}
+
+/*
+ * Trabajo de cada hilo del recorrido: toma tareas hasta que no quedan
+ * o hasta que se corta el recorrido.
+ */
+static void* trabajar_recorrido(void* contexto)
+{
+    reparto_t* reparto = contexto;
+    size_t     i;
+    while ((i = atomic_fetch_add(&reparto->siguiente, 1)) < reparto->cantidad)
+    {
+        tarea_t tarea = reparto->tareas[i];
+        bool    cortado = false;
+        if (tarea.solo_nodo)
+            cortado = !atomic_load(&reparto->cortar) && visitar(reparto, tarea.nodo);
+        else
+            cortado = recorrer(reparto, tarea.nodo);
+        if (cortado)
+        {
+            atomic_store(&reparto->cortar, true);
+            break;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Trabajo de cada hilo de la destruccion: toma tareas hasta que no quedan.
+ */
+static void* trabajar_destruccion(void* contexto)
+{
+    reparto_t* reparto = contexto;
+    size_t     i;
+    while ((i = atomic_fetch_add(&reparto->siguiente, 1)) < reparto->cantidad)
+    {
+        tarea_t tarea = reparto->tareas[i];
+        if (tarea.solo_nodo)
+            reparto->destructor(tarea.nodo->elemento);
+        else
+            destruir_elementos(tarea.nodo, reparto->destructor);
+    }
+    return NULL;
+}
+
+/*
+ * Reparte el arbol en tareas y las ejecuta con la cantidad de hilos
+ * indicada (el hilo que llama es uno de ellos). Nunca se usan mas hilos
+ * que tareas. Si no se pueden crear todos los hilos, se trabaja con los
+ * que se hayan podido crear.
+ *
+ * Devuelve 0 si pudo o -1 si no pudo repartir el arbol (o si la
+ * cantidad de hilos es tan grande que no se pueden contar sus tareas).
+ */
+static int ejecutar(reparto_t* reparto, nodo_abb_t* raiz, size_t hilos, void* (*trabajo)(void*))
+{
+    if (hilos > SIZE_MAX / TAREAS_POR_HILO)
+        return -1;
+    // No hay mas tareas que elementos, asi que no hace falta buscar mas
+    size_t buscadas = hilos * TAREAS_POR_HILO;
+    if (buscadas > tamanio(raiz))
+        buscadas = tamanio(raiz);
+    reparto->cantidad = repartir(raiz, buscadas, &reparto->tareas);
+    if (!reparto->cantidad)
+        return -1;
+    if (hilos > reparto->cantidad)
+        hilos = reparto->cantidad;
+    atomic_init(&reparto->siguiente, 0);
+    atomic_init(&reparto->cortar, false);
+
+    pthread_t* ids = malloc((hilos - 1) * sizeof(pthread_t));
+    size_t     creados = 0;
+    if (ids)
+        while (creados < hilos - 1 && pthread_create(&ids[creados], NULL, trabajo, reparto) == 0)
+            creados++;
+    trabajo(reparto);
+    for (size_t i = 0; i < creados; i++)
+        pthread_join(ids[i], NULL);
+    free(ids);
+    free(reparto->tareas);
+    return 0;
+}
+
+/*
+ * Iterador interno paralelo. Reparte el arbol en subarboles y los
+ * recorre con la cantidad de hilos indicada, invocando la funcion con
+ * cada elemento. El puntero 'extra' se pasa como segundo parámetro a la
+ * función. Si la función devuelve true, se finaliza el recorrido en
+ * todos los hilos lo antes posible.
+ * Cada subarbol se recorre de acuerdo al recorrido solicitado
+ * (ABB_RECORRER_INORDEN, ABB_RECORRER_PREORDEN o ABB_RECORRER_POSTORDEN),
+ * pero no hay ningun orden entre elementos de subarboles distintos:
+ * solo sirve para visitas donde el orden no importa. La funcion es
+ * invocada desde varios hilos a la vez y debe ser segura para ello.
+ * El arbol no debe modificarse durante el recorrido.
+ */
+void abb_con_cada_elemento_paralelo(abb_t* arbol, int recorrido, bool (*funcion)(void*, void*),
+                                    void* extra, size_t hilos)
+{
+    if (!arbol || !funcion)
+        return;
+    if (recorrido != ABB_RECORRER_INORDEN && recorrido != ABB_RECORRER_PREORDEN &&
+        recorrido != ABB_RECORRER_POSTORDEN)
+        return;
+    if (hilos <= 1 || !arbol->nodo_raiz)
+    {
+        abb_con_cada_elemento(arbol, recorrido, funcion, extra);
+        return;
+    }
+    reparto_t reparto = {
+        .arbol = arbol, .recorrido = recorrido, .funcion = funcion, .extra = extra};
+    if (ejecutar(&reparto, arbol->nodo_raiz, hilos, trabajar_recorrido) == -1)
+        abb_con_cada_elemento(arbol, recorrido, funcion, extra);
+}
+
+/*
+ * Destruye el arbol liberando la memoria reservada por el mismo,
+ * invocando el destructor con cada elemento desde la cantidad de hilos
+ * indicada. El destructor debe ser seguro para ser invocado desde
+ * varios hilos a la vez.
+ */
+void arbol_destruir_paralelo(abb_t* arbol, size_t hilos)
+{
+    if (!arbol)
+        return;
+    if (arbol->destructor && hilos > 1 && arbol->nodo_raiz)
+    {
+        reparto_t reparto = {.destructor = arbol->destructor};
+        // Si no se pudo repartir, la destruccion secuencial se encarga de los elementos
+        if (ejecutar(&reparto, arbol->nodo_raiz, hilos, trabajar_destruccion) == 0)
+            arbol->destructor = NULL;
+    }
+    // Los nodos se liberan junto con el pool, sin recorrerlos
+    arbol_destruir(arbol);
+}
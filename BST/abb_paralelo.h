@@ -0,0 +1,33 @@
+#ifndef __ABB_PARALELO_H__
+#define __ABB_PARALELO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "abb.h"
+
+/*
+ * Iterador interno paralelo. Reparte el arbol en subarboles y los
+ * recorre con la cantidad de hilos indicada, invocando la funcion con
+ * cada elemento. El puntero 'extra' se pasa como segundo parámetro a la
+ * función. Si la función devuelve true, se finaliza el recorrido en
+ * todos los hilos lo antes posible.
+ * Cada subarbol se recorre de acuerdo al recorrido solicitado
+ * (ABB_RECORRER_INORDEN, ABB_RECORRER_PREORDEN o ABB_RECORRER_POSTORDEN),
+ * pero no hay ningun orden entre elementos de subarboles distintos:
+ * solo sirve para visitas donde el orden no importa. La funcion es
+ * invocada desde varios hilos a la vez y debe ser segura para ello.
+ * El arbol no debe modificarse durante el recorrido.
+ */
+void abb_con_cada_elemento_paralelo(abb_t* arbol, int recorrido, bool (*funcion)(void*, void*),
+                                    void* extra, size_t hilos);
+
+/*
+ * Destruye el arbol liberando la memoria reservada por el mismo,
+ * invocando el destructor con cada elemento desde la cantidad de hilos
+ * indicada. El destructor debe ser seguro para ser invocado desde
+ * varios hilos a la vez.
+ */
+void arbol_destruir_paralelo(abb_t* arbol, size_t hilos);
+
+#endif /* __ABB_PARALELO_H__ */
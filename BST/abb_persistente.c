@@ -0,0 +1,528 @@
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "abb.h"
+#include "abb_persistente.h"
+
+/*
+ * Un mismo elemento puede estar en nodos de distintas versiones, asi que
+ * se guarda en una celda con su propio conteo de referencias.
+ */
+typedef struct celda
+{
+    void*         elemento;
+    atomic_size_t referencias;
+} celda_t;
+
+typedef struct nodo_persistente
+{
+    celda_t*                 celda;
+    struct nodo_persistente* izquierda;
+    struct nodo_persistente* derecha;
+    union
+    {
+        size_t                   tamanio;   // Mientras el nodo existe
+        struct nodo_persistente* siguiente; // En la pila de nodos a liberar
+    };
+    atomic_size_t referencias;
+} nodo_persistente_t;
+
+struct abb_persistente
+{
+    nodo_persistente_t*  nodo_raiz;
+    abb_comparador       comparador;
+    abb_liberar_elemento destructor;
+};
+
+/*
+ * Crea el arbol y reserva la memoria necesaria de la estructura.
+ * Comparador se utiliza para comparar dos elementos.
+ * Destructor es invocado sobre cada elemento cuando ya no queda
+ * ninguna version del arbol que lo contenga, puede ser NULL indicando
+ * que no se debe utilizar un destructor.
+ *
+ * Devuelve un puntero al arbol creado o NULL en caso de error.
+ */
+abb_persistente_t* arbol_persistente_crear(abb_comparador comparador,
+                                           abb_liberar_elemento destructor)
+{
+    if (!comparador)
+        return NULL;
+    abb_persistente_t* arbol = calloc(1, sizeof(abb_persistente_t));
+    if (!arbol)
+        return NULL;
+    arbol->comparador = comparador;
+    arbol->destructor = destructor;
+    return arbol;
+}
+
+/*
+ * Suelta una referencia a la celda. Si era la ultima, invoca el
+ * destructor (si existe) y libera la celda.
+ */
+static void soltar_celda(celda_t* celda, abb_liberar_elemento destructor)
+{
+    if (atomic_fetch_sub(&celda->referencias, 1) != 1)
+        return;
+    if (destructor)
+        destructor(celda->elemento);
+    free(celda);
+}
+
+/*
+ * Agrega una referencia al nodo (que puede ser NULL) y lo devuelve.
+ */
+static nodo_persistente_t* retener(nodo_persistente_t* nodo)
+{
+    if (nodo)
+        atomic_fetch_add_explicit(&nodo->referencias, 1, memory_order_relaxed);
+    return nodo;
+}
+
+/*
+ * Suelta una referencia al nodo (que puede ser NULL). Si era la ultima,
+ * lo apila para liberarlo.
+ */
+static void apilar_si_muere(nodo_persistente_t** pila, nodo_persistente_t* nodo)
+{
+    if (!nodo || atomic_fetch_sub(&nodo->referencias, 1) != 1)
+        return;
+    nodo->siguiente = *pila;
+    *pila = nodo;
+}
+
+/*
+ * Suelta una referencia al nodo. Si era la ultima, libera el nodo y
+ * suelta las referencias que tenia a su celda y a sus hijos. Los nodos
+ * que quedan sin referencias se liberan desde una pila, sin recursion.
+ */
+static void soltar(nodo_persistente_t* nodo, abb_liberar_elemento destructor)
+{
+    nodo_persistente_t* pila = NULL;
+    apilar_si_muere(&pila, nodo);
+    while (pila)
+    {
+        nodo_persistente_t* actual = pila;
+        pila = actual->siguiente;
+        soltar_celda(actual->celda, destructor);
+        apilar_si_muere(&pila, actual->izquierda);
+        apilar_si_muere(&pila, actual->derecha);
+        free(actual);
+    }
+}
+
+static size_t tamanio(nodo_persistente_t* nodo)
+{
+    if (!nodo)
+        return 0;
+    return nodo->tamanio;
+}
+
+/*
+ * Crea un nodo con la celda y los hijos dados, agregando una referencia
+ * a cada uno de ellos. El nodo creado tiene una unica referencia, que
+ * pertenece a quien lo crea.
+ *
+ * Devuelve NULL en caso de no poder crear.
+ */
+static nodo_persistente_t* nuevo_nodo(celda_t* celda, nodo_persistente_t* izquierda,
+                                      nodo_persistente_t* derecha)
+{
+    nodo_persistente_t* nodo = malloc(sizeof(nodo_persistente_t));
+    if (!nodo)
+        return NULL;
+    atomic_fetch_add_explicit(&celda->referencias, 1, memory_order_relaxed);
+    nodo->celda = celda;
+    nodo->izquierda = retener(izquierda);
+    nodo->derecha = retener(derecha);
+    nodo->tamanio = 1 + tamanio(izquierda) + tamanio(derecha);
+    atomic_init(&nodo->referencias, 1);
+    return nodo;
+}
+
+/*
+ * Crea un nodo como nuevo_nodo, salvo que ya haya habido un error.
+ * Si no puede crearlo, marca el error.
+ *
+ * Devuelve el nodo creado o NULL en caso de error.
+ */
+static nodo_persistente_t* armar(celda_t* celda, nodo_persistente_t* izquierda,
+                                 nodo_persistente_t* derecha, bool* error)
+{
+    if (*error)
+        return NULL;
+    nodo_persistente_t* nodo = nuevo_nodo(celda, izquierda, derecha);
+    if (!nodo)
+        *error = true;
+    return nodo;
+}
+
+/*
+ * Devuelve el peso del subarbol para el balance por peso: su cantidad
+ * de elementos mas uno, asi el subarbol vacio pesa 1.
+ */
+static size_t peso(nodo_persistente_t* nodo)
+{
+    return tamanio(nodo) + 1;
+}
+
+/*
+ * Determina si un subarbol del peso dado es demasiado pesado para tener
+ * de hermano a uno del peso liviano: si pesa mas de 5/2 veces lo que
+ * pesa el otro (2 * pesado > 5 * liviano, sin desbordar).
+ */
+static bool demasiado_pesado(size_t pesado, size_t liviano)
+{
+    return liviano <= pesado / 2 && pesado - 2 * liviano > liviano / 2;
+}
+
+/*
+ * Determina si dos subarboles de los pesos dados pueden ser hermanos.
+ */
+static bool parejos(size_t uno, size_t otro)
+{
+    return !demasiado_pesado(uno, otro) && !demasiado_pesado(otro, uno);
+}
+
+static nodo_persistente_t* juntar(nodo_persistente_t* izquierda, celda_t* celda,
+                                  nodo_persistente_t* derecha, bool* error);
+
+/*
+ * Junta los subarboles con la celda en el medio cuando izquierda es
+ * demasiado pesado: baja por su rama derecha hasta un subarbol parejo
+ * con derecha y, al volver, arma copias rotadas donde haga falta.
+ *
+ * Devuelve la raiz del subarbol nuevo o NULL en caso de error.
+ */
+static nodo_persistente_t* juntar_por_derecha(nodo_persistente_t* izquierda, celda_t* celda,
+                                              nodo_persistente_t* derecha, bool* error)
+{
+    nodo_persistente_t* hijo = juntar(izquierda->derecha, celda, derecha, error);
+    nodo_persistente_t* resto = izquierda->izquierda;
+    nodo_persistente_t* resultado = NULL;
+    if (*error)
+        return NULL;
+    if (parejos(peso(resto), peso(hijo)))
+        resultado = armar(izquierda->celda, resto, hijo, error);
+    // Alcanza una rotacion si el nieto interno queda parejo con el resto, si no van dos
+    else if (!hijo->izquierda ||
+             (parejos(peso(resto), peso(hijo->izquierda)) &&
+              parejos(peso(resto) + peso(hijo->izquierda), peso(hijo->derecha))))
+    {
+        nodo_persistente_t* menores = armar(izquierda->celda, resto, hijo->izquierda, error);
+        resultado = armar(hijo->celda, menores, hijo->derecha, error);
+        soltar(menores, NULL);
+    }
+    else
+    {
+        nodo_persistente_t* nieto = hijo->izquierda;
+        nodo_persistente_t* menores = armar(izquierda->celda, resto, nieto->izquierda, error);
+        nodo_persistente_t* mayores = armar(hijo->celda, nieto->derecha, hijo->derecha, error);
+        resultado = armar(nieto->celda, menores, mayores, error);
+        soltar(menores, NULL);
+        soltar(mayores, NULL);
+    }
+    soltar(hijo, NULL);
+    return resultado;
+}
+
+/*
+ * Simetrica a juntar_por_derecha, para cuando derecha es demasiado pesado.
+ *
+ * Devuelve la raiz del subarbol nuevo o NULL en caso de error.
+ */
+static nodo_persistente_t* juntar_por_izquierda(nodo_persistente_t* izquierda, celda_t* celda,
+                                                nodo_persistente_t* derecha, bool* error)
+{
+    nodo_persistente_t* hijo = juntar(izquierda, celda, derecha->izquierda, error);
+    nodo_persistente_t* resto = derecha->derecha;
+    nodo_persistente_t* resultado = NULL;
+    if (*error)
+        return NULL;
+    if (parejos(peso(resto), peso(hijo)))
+        resultado = armar(derecha->celda, hijo, resto, error);
+    else if (!hijo->derecha ||
+             (parejos(peso(resto), peso(hijo->derecha)) &&
+              parejos(peso(resto) + peso(hijo->derecha), peso(hijo->izquierda))))
+    {
+        nodo_persistente_t* mayores = armar(derecha->celda, hijo->derecha, resto, error);
+        resultado = armar(hijo->celda, hijo->izquierda, mayores, error);
+        soltar(mayores, NULL);
+    }
+    else
+    {
+        nodo_persistente_t* nieto = hijo->derecha;
+        nodo_persistente_t* menores = armar(hijo->celda, hijo->izquierda, nieto->izquierda, error);
+        nodo_persistente_t* mayores = armar(derecha->celda, nieto->derecha, resto, error);
+        resultado = armar(nieto->celda, menores, mayores, error);
+        soltar(menores, NULL);
+        soltar(mayores, NULL);
+    }
+    soltar(hijo, NULL);
+    return resultado;
+}
+
+/*
+ * Arma un subarbol nuevo con los subarboles dados y la celda en el medio
+ * (los elementos de izquierda son menores o iguales al de la celda y los
+ * de derecha mayores o iguales). Los subarboles no se modifican: solo se
+ * copian los nodos de la rama del mas pesado hasta la altura del otro.
+ * Si ambos estan balanceados por peso (ninguna rama pesa mas de 5/2
+ * veces su hermana), el resultado tambien lo esta.
+ * El subarbol devuelto tiene una referencia que pertenece a quien llama.
+ *
+ * Devuelve la raiz del subarbol nuevo o NULL en caso de error.
+ */
+static nodo_persistente_t* juntar(nodo_persistente_t* izquierda, celda_t* celda,
+                                  nodo_persistente_t* derecha, bool* error)
+{
+    if (*error)
+        return NULL;
+    if (demasiado_pesado(peso(izquierda), peso(derecha)))
+        return juntar_por_derecha(izquierda, celda, derecha, error);
+    if (demasiado_pesado(peso(derecha), peso(izquierda)))
+        return juntar_por_izquierda(izquierda, celda, derecha, error);
+    return armar(celda, izquierda, derecha, error);
+}
+
+/*
+ * Inserta recursivamente copiando el camino desde el nodo hasta donde
+ * va la celda, rebalanceando las copias. Ningun nodo existente se
+ * modifica.
+ *
+ * Devuelve la raiz del subarbol nuevo o NULL en caso de error.
+ */
+static nodo_persistente_t* insertar(abb_persistente_t* arbol, nodo_persistente_t* nodo,
+                                    celda_t* celda, bool* error)
+{
+    if (!nodo)
+        return armar(celda, NULL, NULL, error);
+    nodo_persistente_t* hijo = NULL;
+    nodo_persistente_t* copia = NULL;
+    // Igual que en abb_t, los elementos iguales van a la derecha
+    if (arbol->comparador(celda->elemento, nodo->celda->elemento) < 0)
+    {
+        hijo = insertar(arbol, nodo->izquierda, celda, error);
+        copia = juntar(hijo, nodo->celda, nodo->derecha, error);
+    }
+    else
+    {
+        hijo = insertar(arbol, nodo->derecha, celda, error);
+        copia = juntar(nodo->izquierda, nodo->celda, hijo, error);
+    }
+    soltar(hijo, arbol->destructor);
+    return copia;
+}
+
+/*
+ * Inserta un elemento en el arbol, sin afectar a las instantaneas
+ * tomadas previamente.
+ * Devuelve 0 si pudo insertar o -1 si no pudo.
+ * El arbol admite elementos con valores repetidos.
+ */
+int arbol_persistente_insertar(abb_persistente_t* arbol, void* elemento)
+{
+    if (!arbol)
+        return -1;
+    celda_t* celda = malloc(sizeof(celda_t));
+    if (!celda)
+        return -1;
+    celda->elemento = elemento;
+    // La referencia inicial evita que la celda se libere si la insercion falla a mitad de camino
+    atomic_init(&celda->referencias, 1);
+    bool                error = false;
+    nodo_persistente_t* raiz = insertar(arbol, arbol->nodo_raiz, celda, &error);
+    if (error)
+    {
+        soltar(raiz, NULL);
+        soltar_celda(celda, NULL);
+        return -1;
+    }
+    soltar_celda(celda, arbol->destructor);
+    soltar(arbol->nodo_raiz, arbol->destructor);
+    arbol->nodo_raiz = raiz;
+    return 0;
+}
+
+/*
+ * Quita el maximo del subarbol copiando y rebalanceando el camino hasta
+ * el mismo. Guarda en celda la celda del maximo (sin agregarle
+ * referencias).
+ *
+ * Devuelve la raiz del subarbol nuevo (que puede ser NULL si quedo
+ * vacio), o NULL con error en true si no pudo.
+ */
+static nodo_persistente_t* quitar_maximo(nodo_persistente_t* nodo, celda_t** celda, bool* error)
+{
+    if (!nodo->derecha)
+    {
+        *celda = nodo->celda;
+        return retener(nodo->izquierda);
+    }
+    nodo_persistente_t* hijo = quitar_maximo(nodo->derecha, celda, error);
+    nodo_persistente_t* copia = juntar(nodo->izquierda, nodo->celda, hijo, error);
+    soltar(hijo, NULL);
+    return copia;
+}
+
+/*
+ * Borra recursivamente copiando y rebalanceando el camino desde el nodo
+ * hasta el elemento. Marca encontrado si el elemento estaba.
+ *
+ * Devuelve la raiz del subarbol nuevo (que puede ser NULL si quedo
+ * vacio), o NULL si no encontro el elemento o hubo un error (con error
+ * en true). En esos casos no queda ningun nodo nuevo.
+ */
+static nodo_persistente_t* borrar(abb_persistente_t* arbol, nodo_persistente_t* nodo,
+                                  void* elemento, bool* encontrado, bool* error)
+{
+    if (!nodo)
+        return NULL;
+    nodo_persistente_t* hijo = NULL;
+    nodo_persistente_t* copia = NULL;
+    int                 comparacion = arbol->comparador(elemento, nodo->celda->elemento);
+    if (comparacion < 0)
+    {
+        hijo = borrar(arbol, nodo->izquierda, elemento, encontrado, error);
+        if (*encontrado)
+            copia = juntar(hijo, nodo->celda, nodo->derecha, error);
+    }
+    else if (comparacion > 0)
+    {
+        hijo = borrar(arbol, nodo->derecha, elemento, encontrado, error);
+        if (*encontrado)
+            copia = juntar(nodo->izquierda, nodo->celda, hijo, error);
+    }
+    else
+    {
+        *encontrado = true;
+        if (!nodo->izquierda)
+            return retener(nodo->derecha);
+        // El predecesor inorden ocupa el lugar del nodo
+        celda_t* predecesor = NULL;
+        hijo = quitar_maximo(nodo->izquierda, &predecesor, error);
+        copia = juntar(hijo, predecesor, nodo->derecha, error);
+    }
+    soltar(hijo, arbol->destructor);
+    return copia;
+}
+
+/*
+ * Busca en el arbol un elemento igual al provisto (utilizando la
+ * funcion de comparación) y si lo encuentra lo quita del arbol, sin
+ * afectar a las instantaneas tomadas previamente. El destructor se
+ * invoca cuando ninguna version contiene al elemento.
+ * Devuelve 0 si pudo eliminar el elemento o -1 en caso contrario.
+ */
+int arbol_persistente_borrar(abb_persistente_t* arbol, void* elemento)
+{
+    if (!arbol)
+        return -1;
+    bool                encontrado = false;
+    bool                error = false;
+    nodo_persistente_t* raiz = borrar(arbol, arbol->nodo_raiz, elemento, &encontrado, &error);
+    if (!encontrado || error)
+    {
+        soltar(raiz, arbol->destructor);
+        return -1;
+    }
+    soltar(arbol->nodo_raiz, arbol->destructor);
+    arbol->nodo_raiz = raiz;
+    return 0;
+}
+
+/*
+ * Busca en el arbol un elemento igual al provisto (utilizando la
+ * funcion de comparación).
+ *
+ * Devuelve el elemento encontrado o NULL si no lo encuentra.
+ */
+void* arbol_persistente_buscar(abb_persistente_t* arbol, void* elemento)
+{
+    if (!arbol || !elemento)
+        return NULL;
+    nodo_persistente_t* nodo = arbol->nodo_raiz;
+    while (nodo)
+    {
+        int comparacion = arbol->comparador(elemento, nodo->celda->elemento);
+        if (comparacion == 0)
+            return nodo->celda->elemento;
+        nodo = comparacion < 0 ? nodo->izquierda : nodo->derecha;
+    }
+    return NULL;
+}
+
+/*
+ * Devuelve la cantidad de elementos almacenados en el arbol o 0 si el
+ * arbol no existe.
+ */
+size_t arbol_persistente_cantidad(abb_persistente_t* arbol)
+{
+    if (!arbol)
+        return 0;
+    return tamanio(arbol->nodo_raiz);
+}
+
+/*
+ * Toma una instantanea del arbol en O(1). La instantanea es una version
+ * independiente: no ve los cambios que se hagan luego sobre el arbol y
+ * los cambios que se hagan sobre ella no afectan al arbol.
+ * Debe destruirse con arbol_persistente_destruir.
+ *
+ * Devuelve la instantanea o NULL en caso de error.
+ */
+abb_persistente_t* arbol_persistente_snapshot(abb_persistente_t* arbol)
+{
+    if (!arbol)
+        return NULL;
+    abb_persistente_t* instantanea = arbol_persistente_crear(arbol->comparador, arbol->destructor);
+    if (!instantanea)
+        return NULL;
+    instantanea->nodo_raiz = retener(arbol->nodo_raiz);
+    return instantanea;
+}
+
+/*
+ * Recorrido inorden para iterador interno.
+ * Deja de recorrer cuando la funcion devuelva true
+ */
+static bool persistente_inorden(nodo_persistente_t* nodo, bool (*funcion)(void*, void*),
+                                void* extra)
+{
+    if (!nodo)
+        return false;
+    if (persistente_inorden(nodo->izquierda, funcion, extra))
+        return true;
+    if (funcion(nodo->celda->elemento, extra))
+        return true;
+    return persistente_inorden(nodo->derecha, funcion, extra);
+}
+
+/*
+ * Iterador interno. Recorre el arbol en orden e invoca la funcion con
+ * cada elemento del mismo. El puntero 'extra' se pasa como segundo
+ * parámetro a la función. Si la función devuelve true, se finaliza el
+ * recorrido aun si quedan elementos por recorrer.
+ */
+void abb_persistente_con_cada_elemento(abb_persistente_t* arbol, bool (*funcion)(void*, void*),
+                                       void* extra)
+{
+    if (!arbol || !funcion)
+        return;
+    persistente_inorden(arbol->nodo_raiz, funcion, extra);
+}
+
+/*
+ * Destruye esta version del arbol. Los nodos y elementos que no sean
+ * usados por ninguna otra version se liberan, invocando el destructor
+ * con cada elemento liberado.
+ */
+void arbol_persistente_destruir(abb_persistente_t* arbol)
+{
+    if (!arbol)
+        return;
+    soltar(arbol->nodo_raiz, arbol->destructor);
+    free(arbol);
+}
@@ -0,0 +1,96 @@
+#ifndef __ABB_PERSISTENTE_H__
+#define __ABB_PERSISTENTE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "abb.h"
+
+/*
+ * Arbol binario de busqueda persistente. Insertar o borrar no modifica
+ * ningun nodo existente: se copian solamente los nodos del camino desde
+ * la raiz hasta el elemento y el resto se comparte con las versiones
+ * anteriores. Gracias a esto, tomar una instantanea del arbol es O(1) y
+ * la instantanea no se ve afectada por los cambios posteriores.
+ *
+ * El arbol se mantiene balanceado por peso (ninguna rama pesa mas de
+ * 5/2 veces su hermana), asi que su altura es O(log n) y cada insercion
+ * o borrado copia O(log n) nodos, rotando las copias cuando hace falta.
+ *
+ * Los nodos y los elementos se liberan por conteo de referencias cuando
+ * ninguna version los usa. Cada version debe ser usada por un solo hilo
+ * a la vez, pero versiones distintas pueden usarse y destruirse desde
+ * hilos distintos en paralelo.
+ */
+typedef struct abb_persistente abb_persistente_t;
+
+/*
+ * Crea el arbol y reserva la memoria necesaria de la estructura.
+ * Comparador se utiliza para comparar dos elementos.
+ * Destructor es invocado sobre cada elemento cuando ya no queda
+ * ninguna version del arbol que lo contenga, puede ser NULL indicando
+ * que no se debe utilizar un destructor.
+ *
+ * Devuelve un puntero al arbol creado o NULL en caso de error.
+ */
+abb_persistente_t* arbol_persistente_crear(abb_comparador comparador,
+                                           abb_liberar_elemento destructor);
+
+/*
+ * Inserta un elemento en el arbol, sin afectar a las instantaneas
+ * tomadas previamente.
+ * Devuelve 0 si pudo insertar o -1 si no pudo.
+ * El arbol admite elementos con valores repetidos.
+ */
+int arbol_persistente_insertar(abb_persistente_t* arbol, void* elemento);
+
+/*
+ * Busca en el arbol un elemento igual al provisto (utilizando la
+ * funcion de comparación) y si lo encuentra lo quita del arbol, sin
+ * afectar a las instantaneas tomadas previamente. El destructor se
+ * invoca cuando ninguna version contiene al elemento.
+ * Devuelve 0 si pudo eliminar el elemento o -1 en caso contrario.
+ */
+int arbol_persistente_borrar(abb_persistente_t* arbol, void* elemento);
+
+/*
+ * Busca en el arbol un elemento igual al provisto (utilizando la
+ * funcion de comparación).
+ *
+ * Devuelve el elemento encontrado o NULL si no lo encuentra.
+ */
+void* arbol_persistente_buscar(abb_persistente_t* arbol, void* elemento);
+
+/*
+ * Devuelve la cantidad de elementos almacenados en el arbol o 0 si el
+ * arbol no existe.
+ */
+size_t arbol_persistente_cantidad(abb_persistente_t* arbol);
+
+/*
+ * Toma una instantanea del arbol en O(1). La instantanea es una version
+ * independiente: no ve los cambios que se hagan luego sobre el arbol y
+ * los cambios que se hagan sobre ella no afectan al arbol.
+ * Debe destruirse con arbol_persistente_destruir.
+ *
+ * Devuelve la instantanea o NULL en caso de error.
+ */
+abb_persistente_t* arbol_persistente_snapshot(abb_persistente_t* arbol);
+
+/*
+ * Iterador interno. Recorre el arbol en orden e invoca la funcion con
+ * cada elemento del mismo. El puntero 'extra' se pasa como segundo
+ * parámetro a la función. Si la función devuelve true, se finaliza el
+ * recorrido aun si quedan elementos por recorrer.
+ */
+void abb_persistente_con_cada_elemento(abb_persistente_t* arbol, bool (*funcion)(void*, void*),
+                                       void* extra);
+
+/*
+ * Destruye esta version del arbol. Los nodos y elementos que no sean
+ * usados por ninguna otra version se liberan, invocando el destructor
+ * con cada elemento liberado.
+ */
+void arbol_persistente_destruir(abb_persistente_t* arbol);
+
+#endif /* __ABB_PERSISTENTE_H__ */
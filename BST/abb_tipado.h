@@ -0,0 +1,165 @@
+#ifndef __ABB_TIPADO_H__
+#define __ABB_TIPADO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+/*
+ * Generador de arboles binarios de busqueda especializados para un tipo.
+ *
+ * ABB_DEFINIR(nombre, tipo, comparar) define el tipo nombre_t y sus
+ * primitivas. Las claves se guardan por valor dentro de cada nodo (sin
+ * reservar memoria aparte por elemento) y la comparacion es una
+ * expresion que el compilador puede expandir en linea, en lugar de una
+ * llamada a traves de un puntero a funcion.
+ *
+ * comparar debe ser una funcion o macro que reciba dos valores de tipo
+ * 'tipo' y devuelva un numero negativo, 0 o positivo si el primero es
+ * menor, igual o mayor al segundo, por ejemplo:
+ *
+ *     #define COMPARAR_INT(a, b) (((a) > (b)) - ((a) < (b)))
+ *     ABB_DEFINIR(abb_int, int, COMPARAR_INT)
+ *
+ * Las primitivas definidas son:
+ *
+ *   nombre_t* nombre_crear(void);
+ *   int       nombre_insertar(nombre_t* arbol, tipo clave);
+ *   int       nombre_borrar(nombre_t* arbol, tipo clave);
+ *   tipo*     nombre_buscar(nombre_t* arbol, tipo clave);
+ *   size_t    nombre_cantidad(nombre_t* arbol);
+ *   bool      nombre_vacio(nombre_t* arbol);
+ *   void      nombre_con_cada_elemento(nombre_t* arbol, bool (*funcion)(tipo*, void*), void* extra);
+ *   void      nombre_destruir(nombre_t* arbol);
+ *
+ * Con la misma semantica que las de abb.h: se admiten claves repetidas,
+ * insertar y borrar devuelven 0 o -1, buscar devuelve un puntero a la
+ * clave guardada en el arbol o NULL y el recorrido es inorden. Como las
+ * claves se guardan por valor, no hay destructor.
+ */
+#define ABB_DEFINIR(nombre, tipo, comparar)                                                        \
+                                                                                                   \
+    typedef struct nombre##_nodo                                                                   \
+    {                                                                                              \
+        struct nombre##_nodo* izquierda;                                                           \
+        struct nombre##_nodo* derecha;                                                             \
+        tipo                  clave;                                                               \
+    } nombre##_nodo_t;                                                                             \
+                                                                                                   \
+    typedef struct nombre                                                                          \
+    {                                                                                              \
+        nombre##_nodo_t* nodo_raiz;                                                                \
+        size_t           cantidad;                                                                 \
+    } nombre##_t;                                                                                  \
+                                                                                                   \
+    static inline nombre##_t* nombre##_crear(void)                                                 \
+    {                                                                                              \
+        return calloc(1, sizeof(nombre##_t));                                                      \
+    }                                                                                              \
+                                                                                                   \
+    static inline int nombre##_insertar(nombre##_t* arbol, tipo clave)                             \
+    {                                                                                              \
+        if (!arbol)                                                                                \
+            return -1;                                                                             \
+        nombre##_nodo_t** lugar = &arbol->nodo_raiz;                                               \
+        while (*lugar)                                                                             \
+            lugar = comparar(clave, (*lugar)->clave) < 0 ? &(*lugar)->izquierda                   \
+                                                         : &(*lugar)->derecha;                     \
+        nombre##_nodo_t* nodo = calloc(1, sizeof(nombre##_nodo_t));                                \
+        if (!nodo)                                                                                 \
+            return -1;                                                                             \
+        nodo->clave = clave;                                                                       \
+        *lugar = nodo;                                                                             \
+        arbol->cantidad++;                                                                         \
+        return 0;                                                                                  \
+    }                                                                                              \
+                                                                                                   \
+    static inline int nombre##_borrar(nombre##_t* arbol, tipo clave)                               \
+    {                                                                                              \
+        if (!arbol)                                                                                \
+            return -1;                                                                             \
+        nombre##_nodo_t** lugar = &arbol->nodo_raiz;                                               \
+        int               comparacion = 0;                                                         \
+        while (*lugar && (comparacion = comparar(clave, (*lugar)->clave)) != 0)                    \
+            lugar = comparacion < 0 ? &(*lugar)->izquierda : &(*lugar)->derecha;                   \
+        nombre##_nodo_t* nodo = *lugar;                                                            \
+        if (!nodo)                                                                                 \
+            return -1;                                                                             \
+        if (nodo->izquierda && nodo->derecha)                                                      \
+        {                                                                                          \
+            /* Dos hijos: se reemplaza la clave por la del predecesor y se borra ese nodo */     \
+            nombre##_nodo_t** predecesor = &nodo->izquierda;                                       \
+            while ((*predecesor)->derecha)                                                         \
+                predecesor = &(*predecesor)->derecha;                                              \
+            nodo->clave = (*predecesor)->clave;                                                    \
+            lugar = predecesor;                                                                    \
+            nodo = *lugar;                                                                         \
+        }                                                                                          \
+        *lugar = nodo->izquierda ? nodo->izquierda : nodo->derecha;                                \
+        free(nodo);                                                                                \
+        arbol->cantidad--;                                                                         \
+        return 0;                                                                                  \
+    }                                                                                              \
+                                                                                                   \
+    static inline tipo* nombre##_buscar(nombre##_t* arbol, tipo clave)                             \
+    {                                                                                              \
+        if (!arbol)                                                                                \
+            return NULL;                                                                           \
+        nombre##_nodo_t* nodo = arbol->nodo_raiz;                                                  \
+        while (nodo)                                                                               \
+        {                                                                                          \
+            int comparacion = comparar(clave, nodo->clave);                                        \
+            if (comparacion == 0)                                                                  \
+                return &nodo->clave;                                                               \
+            nodo = comparacion < 0 ? nodo->izquierda : nodo->derecha;                              \
+        }                                                                                          \
+        return NULL;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline size_t nombre##_cantidad(nombre##_t* arbol)                                      \
+    {                                                                                              \
+        return arbol ? arbol->cantidad : 0;                                                        \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool nombre##_vacio(nombre##_t* arbol)                                           \
+    {                                                                                              \
+        return nombre##_cantidad(arbol) == 0;                                                      \
+    }                                                                                              \
+                                                                                                   \
+    static inline bool nombre##_inorden(nombre##_nodo_t* nodo, bool (*funcion)(tipo*, void*),     \
+                                        void* extra)                                               \
+    {                                                                                              \
+        if (!nodo)                                                                                 \
+            return false;                                                                          \
+        if (nombre##_inorden(nodo->izquierda, funcion, extra))                                     \
+            return true;                                                                           \
+        if (funcion(&nodo->clave, extra))                                                          \
+            return true;                                                                           \
+        return nombre##_inorden(nodo->derecha, funcion, extra);                                    \
+    }                                                                                              \
+                                                                                                   \
+    static inline void nombre##_con_cada_elemento(nombre##_t* arbol,                               \
+                                                  bool (*funcion)(tipo*, void*), void* extra)      \
+    {                                                                                              \
+        if (arbol && funcion)                                                                      \
+            nombre##_inorden(arbol->nodo_raiz, funcion, extra);                                    \
+    }                                                                                              \
+                                                                                                   \
+    static inline void nombre##_destruir_nodos(nombre##_nodo_t* nodo)                             \
+    {                                                                                              \
+        if (!nodo)                                                                                 \
+            return;                                                                                \
+        nombre##_destruir_nodos(nodo->izquierda);                                                  \
+        nombre##_destruir_nodos(nodo->derecha);                                                    \
+        free(nodo);                                                                                \
+    }                                                                                              \
+                                                                                                   \
+    static inline void nombre##_destruir(nombre##_t* arbol)                                        \
+    {                                                                                              \
+        if (!arbol)                                                                                \
+            return;                                                                                \
+        nombre##_destruir_nodos(arbol->nodo_raiz);                                                 \
+        free(arbol);                                                                               \
+    }
+
+#endif /* __ABB_TIPADO_H__ */
@@ -0,0 +1,193 @@
+#include "buffer_circular.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPACIDAD_INICIAL 16 // Capacidad del vector al crear el buffer, siempre potencia de 2
+
+/*
+ * Los elementos ocupan las posiciones [inicio, inicio + cantidad) del
+ * vector, dando la vuelta al final. Como en lista.h, se encola por el
+ * principio y se desencola, apila y desapila por el final.
+ */
+struct buffer_circular
+{
+    void** datos;
+    size_t capacidad; // Potencia de 2, para calcular las posiciones con una mascara
+    size_t inicio;
+    size_t cantidad;
+    size_t capacidad_maxima;
+};
+
+/*
+ * Crea el buffer reservando la memoria necesaria.
+ * Capacidad maxima es la cantidad de elementos que puede almacenar como
+ * maximo, o 0 para que crezca sin limite.
+ * Devuelve un puntero al buffer creado o NULL en caso de error.
+ */
+buffer_circular_t* buffer_circular_crear(size_t capacidad_maxima)
+{
+    if (capacidad_maxima > SIZE_MAX / 2)
+        return NULL;
+    buffer_circular_t* buffer = calloc(1, sizeof(buffer_circular_t));
+    if (!buffer)
+        return NULL;
+    // Con capacidad maxima tambien se empieza chico y se crece a demanda, hasta la maxima
+    size_t capacidad = CAPACIDAD_INICIAL;
+    if (capacidad_maxima && capacidad_maxima < CAPACIDAD_INICIAL)
+        for (capacidad = 1; capacidad < capacidad_maxima; capacidad *= 2)
+            ;
+    buffer->datos = malloc(capacidad * sizeof(void*));
+    if (!buffer->datos)
+    {
+        free(buffer);
+        return NULL;
+    }
+    buffer->capacidad = capacidad;
+    buffer->capacidad_maxima = capacidad_maxima;
+    return buffer;
+}
+
+/*
+ * Devuelve la posicion del vector del elemento en la posicion dada,
+ * donde 0 es el principio.
+ */
+static size_t posicion(buffer_circular_t* buffer, size_t indice)
+{
+    return (buffer->inicio + indice) & (buffer->capacidad - 1);
+}
+
+/*
+ * Se asegura de que haya lugar para un elemento mas, duplicando el
+ * vector si esta lleno.
+ * Devuelve 0 si hay lugar o -1 si no lo hay y no pudo crecer.
+ */
+static int reservar_lugar(buffer_circular_t* buffer)
+{
+    if (buffer_circular_lleno(buffer))
+        return -1;
+    if (buffer->cantidad < buffer->capacidad)
+        return 0;
+    void** datos = malloc(2 * buffer->capacidad * sizeof(void*));
+    if (!datos)
+        return -1;
+    // Se copian los dos tramos en orden, asi en el vector nuevo empiezan en 0
+    size_t hasta_el_final = buffer->capacidad - buffer->inicio;
+    memcpy(datos, buffer->datos + buffer->inicio, hasta_el_final * sizeof(void*));
+    memcpy(datos + hasta_el_final, buffer->datos, buffer->inicio * sizeof(void*));
+    free(buffer->datos);
+    buffer->datos = datos;
+    buffer->capacidad *= 2;
+    buffer->inicio = 0;
+    return 0;
+}
+
+/*
+ * Devuelve true si el buffer está vacío o false en caso contrario.
+ */
+bool buffer_circular_vacio(buffer_circular_t* buffer)
+{
+    return (buffer_circular_elementos(buffer) == 0);
+}
+
+/*
+ * Devuelve true si el buffer tiene capacidad maxima y la alcanzo.
+ */
+bool buffer_circular_lleno(buffer_circular_t* buffer)
+{
+    if (!buffer || !buffer->capacidad_maxima)
+        return false;
+    return buffer->cantidad >= buffer->capacidad_maxima;
+}
+
+/*
+ * Devuelve la cantidad de elementos almacenados en el buffer.
+ */
+size_t buffer_circular_elementos(buffer_circular_t* buffer)
+{
+    if (buffer)
+        return buffer->cantidad;
+    return 0;
+}
+
+/*
+ * Apila un elemento.
+ * Devuelve 0 si pudo o -1 en caso contrario.
+ */
+int buffer_circular_apilar(buffer_circular_t* buffer, void* elemento)
+{
+    if (!buffer || reservar_lugar(buffer) == -1)
+        return -1;
+    buffer->datos[posicion(buffer, buffer->cantidad)] = elemento;
+    buffer->cantidad++;
+    return 0;
+}
+
+/*
+ * Desapila un elemento.
+ * Devuelve 0 si pudo desapilar o -1 si no pudo.
+ */
+int buffer_circular_desapilar(buffer_circular_t* buffer)
+{
+    if (buffer_circular_vacio(buffer))
+        return -1;
+    buffer->cantidad--;
+    return 0;
+}
+
+/*
+ * Devuelve el elemento en el tope de la pila o NULL
+ * en caso de estar vacía.
+ */
+void* buffer_circular_tope(buffer_circular_t* buffer)
+{
+    if (buffer_circular_vacio(buffer))
+        return NULL;
+    return buffer->datos[posicion(buffer, buffer->cantidad - 1)];
+}
+
+/*
+ * Encola un elemento.
+ * Devuelve 0 si pudo encolar o -1 si no pudo.
+ */
+int buffer_circular_encolar(buffer_circular_t* buffer, void* elemento)
+{
+    if (!buffer || reservar_lugar(buffer) == -1)
+        return -1;
+    buffer->inicio = (buffer->inicio - 1) & (buffer->capacidad - 1);
+    buffer->datos[buffer->inicio] = elemento;
+    buffer->cantidad++;
+    return 0;
+}
+
+/*
+ * Desencola un elemento.
+ * Devuelve 0 si pudo desencolar o -1 si no pudo.
+ */
+int buffer_circular_desencolar(buffer_circular_t* buffer)
+{
+    return buffer_circular_desapilar(buffer);
+}
+
+/*
+ * Devuelve el primer elemento de la cola o NULL en caso de estar
+ * vacía.
+ */
+void* buffer_circular_primero(buffer_circular_t* buffer)
+{
+    return buffer_circular_tope(buffer);
+}
+
+/*
+ * Libera la memoria reservada por el buffer.
+ */
+void buffer_circular_destruir(buffer_circular_t* buffer)
+{
+    if (!buffer)
+        return;
+    free(buffer->datos);
+    free(buffer);
+}
@@ -0,0 +1,79 @@
+#ifndef __BUFFER_CIRCULAR_H__
+#define __BUFFER_CIRCULAR_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Pila y cola sobre un vector circular, con las mismas operaciones (y
+ * el mismo comportamiento) que las de lista.h, pero sin reservar
+ * memoria por cada elemento. El vector crece al doble cuando se llena,
+ * salvo que se haya fijado una capacidad maxima.
+ */
+typedef struct buffer_circular buffer_circular_t;
+
+/*
+ * Crea el buffer reservando la memoria necesaria.
+ * Capacidad maxima es la cantidad de elementos que puede almacenar como
+ * maximo, o 0 para que crezca sin limite.
+ * Devuelve un puntero al buffer creado o NULL en caso de error.
+ */
+buffer_circular_t* buffer_circular_crear(size_t capacidad_maxima);
+
+/*
+ * Devuelve true si el buffer está vacío o false en caso contrario.
+ */
+bool buffer_circular_vacio(buffer_circular_t* buffer);
+
+/*
+ * Devuelve true si el buffer tiene capacidad maxima y la alcanzo.
+ */
+bool buffer_circular_lleno(buffer_circular_t* buffer);
+
+/*
+ * Devuelve la cantidad de elementos almacenados en el buffer.
+ */
+size_t buffer_circular_elementos(buffer_circular_t* buffer);
+
+/*
+ * Apila un elemento.
+ * Devuelve 0 si pudo o -1 en caso contrario.
+ */
+int buffer_circular_apilar(buffer_circular_t* buffer, void* elemento);
+
+/*
+ * Desapila un elemento.
+ * Devuelve 0 si pudo desapilar o -1 si no pudo.
+ */
+int buffer_circular_desapilar(buffer_circular_t* buffer);
+
+/*
+ * Devuelve el elemento en el tope de la pila o NULL
+ * en caso de estar vacía.
+ */
+void* buffer_circular_tope(buffer_circular_t* buffer);
+
+/*
+ * Encola un elemento.
+ * Devuelve 0 si pudo encolar o -1 si no pudo.
+ */
+int buffer_circular_encolar(buffer_circular_t* buffer, void* elemento);
+
+/*
+ * Desencola un elemento.
+ * Devuelve 0 si pudo desencolar o -1 si no pudo.
+ */
+int buffer_circular_desencolar(buffer_circular_t* buffer);
+
+/*
+ * Devuelve el primer elemento de la cola o NULL en caso de estar
+ * vacía.
+ */
+void* buffer_circular_primero(buffer_circular_t* buffer);
+
+/*
+ * Libera la memoria reservada por el buffer.
+ */
+void buffer_circular_destruir(buffer_circular_t* buffer);
+
+#endif /* __BUFFER_CIRCULAR_H__ */
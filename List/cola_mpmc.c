@@ -0,0 +1,226 @@
+#include "cola_mpmc.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TAMANIO_LINEA_CACHE 64 // Las posiciones compartidas van en lineas de cache distintas
+
+/*
+ * Cada celda tiene un numero de secuencia. La celda de la posicion p
+ * esta libre para el productor de p cuando su secuencia es p, y tiene
+ * un elemento para el consumidor de p cuando su secuencia es p + 1. Al
+ * desencolar, la secuencia pasa a p + capacidad, la posicion que la
+ * reutiliza en la vuelta siguiente.
+ */
+typedef struct celda
+{
+    atomic_size_t secuencia;
+    void*         dato;
+} celda_t;
+
+struct cola_mpmc
+{
+    _Alignas(TAMANIO_LINEA_CACHE) atomic_size_t posicion_encolar;
+    _Alignas(TAMANIO_LINEA_CACHE) atomic_size_t posicion_desencolar;
+    _Alignas(TAMANIO_LINEA_CACHE) size_t mascara;
+    celda_t* celdas;
+};
+
+/*
+ * Crea la cola reservando la memoria necesaria. La capacidad se redondea
+ * a la potencia de 2 siguiente.
+ * Devuelve un puntero a la cola creada o NULL en caso de error.
+ */
+cola_mpmc_t* cola_mpmc_crear(size_t capacidad)
+{
+    if (!capacidad || capacidad > SIZE_MAX / 2)
+        return NULL;
+    size_t potencia = 2;
+    while (potencia < capacidad)
+        potencia *= 2;
+    cola_mpmc_t* cola = aligned_alloc(TAMANIO_LINEA_CACHE, sizeof(cola_mpmc_t));
+    if (!cola)
+        return NULL;
+    memset(cola, 0, sizeof(cola_mpmc_t));
+    cola->celdas = malloc(potencia * sizeof(celda_t));
+    if (!cola->celdas)
+    {
+        free(cola);
+        return NULL;
+    }
+    for (size_t i = 0; i < potencia; i++)
+        atomic_init(&cola->celdas[i].secuencia, i);
+    cola->mascara = potencia - 1;
+    atomic_init(&cola->posicion_encolar, 0);
+    atomic_init(&cola->posicion_desencolar, 0);
+    return cola;
+}
+
+/*
+ * Devuelve la celda de la posicion dada.
+ */
+static celda_t* celda(cola_mpmc_t* cola, size_t posicion)
+{
+    return &cola->celdas[posicion & cola->mascara];
+}
+
+/*
+ * Cuenta cuantas celdas consecutivas desde la posicion (hasta maximo)
+ * tienen la secuencia esperada, es decir, estan listas para la
+ * operacion. Desplazamiento es 0 para encolar y 1 para desencolar.
+ * En diferencia deja la diferencia entre la secuencia de la primera
+ * celda y la esperada.
+ */
+static size_t celdas_listas(cola_mpmc_t* cola, size_t posicion, size_t desplazamiento,
+                            size_t maximo, intptr_t* diferencia)
+{
+    size_t listas = 0;
+    while (listas < maximo)
+    {
+        size_t esperada = posicion + listas + desplazamiento;
+        size_t secuencia = atomic_load_explicit(&celda(cola, posicion + listas)->secuencia,
+                                                memory_order_acquire);
+        if (listas == 0)
+            *diferencia = (intptr_t)secuencia - (intptr_t)esperada;
+        if (secuencia != esperada)
+            break;
+        listas++;
+    }
+    return listas;
+}
+
+/*
+ * Reserva hasta maximo posiciones consecutivas listas desde la posicion
+ * compartida, avanzandola con una sola operacion atomica.
+ * Desplazamiento es 0 para encolar y 1 para desencolar.
+ * Deja en inicio la primera posicion reservada.
+ * Devuelve la cantidad de posiciones reservadas, 0 si no hay ninguna
+ * lista (cola llena al encolar o vacia al desencolar).
+ */
+static size_t reservar(cola_mpmc_t* cola, atomic_size_t* compartida, size_t desplazamiento,
+                       size_t maximo, size_t* inicio)
+{
+    size_t posicion = atomic_load_explicit(compartida, memory_order_relaxed);
+    while (true)
+    {
+        intptr_t diferencia = 0;
+        size_t   listas = celdas_listas(cola, posicion, desplazamiento, maximo, &diferencia);
+        if (listas)
+        {
+            // Si otro hilo avanzo la posicion, se reintenta desde la nueva
+            if (atomic_compare_exchange_weak_explicit(compartida, &posicion, posicion + listas,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+            {
+                *inicio = posicion;
+                return listas;
+            }
+        }
+        // La celda todavia es de la vuelta anterior: la cola esta llena o vacia
+        else if (diferencia < 0)
+            return 0;
+        else
+            posicion = atomic_load_explicit(compartida, memory_order_relaxed);
+    }
+}
+
+/*
+ * Encola, en orden y en posiciones consecutivas de la cola, la mayor
+ * cantidad posible de los elementos del vector.
+ * Devuelve la cantidad de elementos encolados (0 si la cola esta llena).
+ */
+size_t cola_mpmc_encolar_varios(cola_mpmc_t* cola, void** elementos, size_t cantidad)
+{
+    if (!cola || !elementos || !cantidad)
+        return 0;
+    size_t inicio = 0;
+    size_t reservadas = reservar(cola, &cola->posicion_encolar, 0, cantidad, &inicio);
+    for (size_t i = 0; i < reservadas; i++)
+    {
+        celda_t* actual = celda(cola, inicio + i);
+        actual->dato = elementos[i];
+        atomic_store_explicit(&actual->secuencia, inicio + i + 1, memory_order_release);
+    }
+    return reservadas;
+}
+
+/*
+ * Desencola hasta cantidad elementos consecutivos y los guarda en orden
+ * en el vector.
+ * Devuelve la cantidad de elementos desencolados (0 si la cola esta
+ * vacia).
+ */
+size_t cola_mpmc_desencolar_varios(cola_mpmc_t* cola, void** elementos, size_t cantidad)
+{
+    if (!cola || !elementos || !cantidad)
+        return 0;
+    size_t inicio = 0;
+    size_t reservadas = reservar(cola, &cola->posicion_desencolar, 1, cantidad, &inicio);
+    for (size_t i = 0; i < reservadas; i++)
+    {
+        celda_t* actual = celda(cola, inicio + i);
+        elementos[i] = actual->dato;
+        atomic_store_explicit(&actual->secuencia, inicio + i + cola->mascara + 1,
+                              memory_order_release);
+    }
+    return reservadas;
+}
+
+/*
+ * Encola un elemento.
+ * Devuelve 0 si pudo encolar o -1 si la cola esta llena.
+ */
+int cola_mpmc_encolar(cola_mpmc_t* cola, void* elemento)
+{
+    return cola_mpmc_encolar_varios(cola, &elemento, 1) == 1 ? 0 : -1;
+}
+
+/*
+ * Desencola un elemento y lo guarda en elemento.
+ * Devuelve 0 si pudo desencolar o -1 si la cola esta vacia.
+ */
+int cola_mpmc_desencolar(cola_mpmc_t* cola, void** elemento)
+{
+    return cola_mpmc_desencolar_varios(cola, elemento, 1) == 1 ? 0 : -1;
+}
+
+/*
+ * Devuelve la cantidad de elementos en la cola. Si otros hilos la estan
+ * modificando, el valor es aproximado.
+ */
+size_t cola_mpmc_elementos(cola_mpmc_t* cola)
+{
+    if (!cola)
+        return 0;
+    size_t desencolar = atomic_load_explicit(&cola->posicion_desencolar, memory_order_relaxed);
+    size_t encolar = atomic_load_explicit(&cola->posicion_encolar, memory_order_relaxed);
+    // Leidas por separado, la de desencolar puede haber quedado adelante
+    if (encolar < desencolar)
+        return 0;
+    return encolar - desencolar;
+}
+
+/*
+ * Devuelve true si la cola está vacía o false en caso contrario. Si
+ * otros hilos la estan modificando, el valor es aproximado.
+ */
+bool cola_mpmc_vacia(cola_mpmc_t* cola)
+{
+    return (cola_mpmc_elementos(cola) == 0);
+}
+
+/*
+ * Libera la memoria reservada por la cola. Ningun otro hilo puede
+ * estar usandola.
+ */
+void cola_mpmc_destruir(cola_mpmc_t* cola)
+{
+    if (!cola)
+        return;
+    free(cola->celdas);
+    free(cola);
+}
@@ -0,0 +1,71 @@
+#ifndef __COLA_MPMC_H__
+#define __COLA_MPMC_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Cola acotada para varios productores y varios consumidores, sin
+ * locks: cada posicion del vector circular tiene un numero de secuencia
+ * que indica si esta libre u ocupada en la vuelta actual, y los hilos se
+ * reparten las posiciones con una sola operacion atomica.
+ *
+ * A diferencia de lista.h, desencolar devuelve el elemento quitado, ya
+ * que con varios consumidores mirar el primero y luego desencolarlo no
+ * es atomico.
+ */
+typedef struct cola_mpmc cola_mpmc_t;
+
+/*
+ * Crea la cola reservando la memoria necesaria. La capacidad se redondea
+ * a la potencia de 2 siguiente.
+ * Devuelve un puntero a la cola creada o NULL en caso de error.
+ */
+cola_mpmc_t* cola_mpmc_crear(size_t capacidad);
+
+/*
+ * Encola un elemento.
+ * Devuelve 0 si pudo encolar o -1 si la cola esta llena.
+ */
+int cola_mpmc_encolar(cola_mpmc_t* cola, void* elemento);
+
+/*
+ * Desencola un elemento y lo guarda en elemento.
+ * Devuelve 0 si pudo desencolar o -1 si la cola esta vacia.
+ */
+int cola_mpmc_desencolar(cola_mpmc_t* cola, void** elemento);
+
+/*
+ * Encola, en orden y en posiciones consecutivas de la cola, la mayor
+ * cantidad posible de los elementos del vector.
+ * Devuelve la cantidad de elementos encolados (0 si la cola esta llena).
+ */
+size_t cola_mpmc_encolar_varios(cola_mpmc_t* cola, void** elementos, size_t cantidad);
+
+/*
+ * Desencola hasta cantidad elementos consecutivos y los guarda en orden
+ * en el vector.
+ * Devuelve la cantidad de elementos desencolados (0 si la cola esta
+ * vacia).
+ */
+size_t cola_mpmc_desencolar_varios(cola_mpmc_t* cola, void** elementos, size_t cantidad);
+
+/*
+ * Devuelve la cantidad de elementos en la cola. Si otros hilos la estan
+ * modificando, el valor es aproximado.
+ */
+size_t cola_mpmc_elementos(cola_mpmc_t* cola);
+
+/*
+ * Devuelve true si la cola está vacía o false en caso contrario. Si
+ * otros hilos la estan modificando, el valor es aproximado.
+ */
+bool cola_mpmc_vacia(cola_mpmc_t* cola);
+
+/*
+ * Libera la memoria reservada por la cola. Ningun otro hilo puede
+ * estar usandola.
+ */
+void cola_mpmc_destruir(cola_mpmc_t* cola);
+
+#endif /* __COLA_MPMC_H__ */
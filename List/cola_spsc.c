@@ -0,0 +1,178 @@
+#include "cola_spsc.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TAMANIO_LINEA_CACHE 64 // Los datos de cada hilo van en lineas de cache distintas
+
+/*
+ * Las posiciones crecen sin limite y se reducen con la mascara al
+ * acceder al vector. Cada hilo guarda, en su propia linea de cache, una
+ * copia de la ultima posicion que leyo del otro, y solo vuelve a leer la
+ * posicion compartida cuando la copia no le alcanza (la cola parece
+ * llena para el productor o vacia para el consumidor).
+ */
+struct cola_spsc
+{
+    _Alignas(TAMANIO_LINEA_CACHE) atomic_size_t posicion_encolar;
+    size_t desencolar_conocida; // Copia del productor
+    _Alignas(TAMANIO_LINEA_CACHE) atomic_size_t posicion_desencolar;
+    size_t encolar_conocida; // Copia del consumidor
+    _Alignas(TAMANIO_LINEA_CACHE) size_t mascara;
+    void** datos;
+};
+
+/*
+ * Crea la cola reservando la memoria necesaria. La capacidad se redondea
+ * a la potencia de 2 siguiente.
+ * Devuelve un puntero a la cola creada o NULL en caso de error.
+ */
+cola_spsc_t* cola_spsc_crear(size_t capacidad)
+{
+    if (!capacidad || capacidad > SIZE_MAX / 2)
+        return NULL;
+    size_t potencia = 1;
+    while (potencia < capacidad)
+        potencia *= 2;
+    cola_spsc_t* cola = aligned_alloc(TAMANIO_LINEA_CACHE, sizeof(cola_spsc_t));
+    if (!cola)
+        return NULL;
+    memset(cola, 0, sizeof(cola_spsc_t));
+    cola->datos = malloc(potencia * sizeof(void*));
+    if (!cola->datos)
+    {
+        free(cola);
+        return NULL;
+    }
+    cola->mascara = potencia - 1;
+    atomic_init(&cola->posicion_encolar, 0);
+    atomic_init(&cola->posicion_desencolar, 0);
+    return cola;
+}
+
+/*
+ * Encola en orden la mayor cantidad posible de los elementos del
+ * vector. Solo desde el hilo productor.
+ * Devuelve la cantidad de elementos encolados (0 si la cola esta llena).
+ */
+size_t cola_spsc_encolar_varios(cola_spsc_t* cola, void** elementos, size_t cantidad)
+{
+    if (!cola || !elementos)
+        return 0;
+    size_t capacidad = cola->mascara + 1;
+    size_t encolar = atomic_load_explicit(&cola->posicion_encolar, memory_order_relaxed);
+    size_t libres = capacidad - (encolar - cola->desencolar_conocida);
+    if (libres < cantidad)
+    {
+        cola->desencolar_conocida =
+            atomic_load_explicit(&cola->posicion_desencolar, memory_order_acquire);
+        libres = capacidad - (encolar - cola->desencolar_conocida);
+    }
+    if (cantidad > libres)
+        cantidad = libres;
+    for (size_t i = 0; i < cantidad; i++)
+        cola->datos[(encolar + i) & cola->mascara] = elementos[i];
+    atomic_store_explicit(&cola->posicion_encolar, encolar + cantidad, memory_order_release);
+    return cantidad;
+}
+
+/*
+ * Desencola hasta cantidad elementos y los guarda en orden en el
+ * vector. Solo desde el hilo consumidor.
+ * Devuelve la cantidad de elementos desencolados (0 si la cola esta
+ * vacia).
+ */
+size_t cola_spsc_desencolar_varios(cola_spsc_t* cola, void** elementos, size_t cantidad)
+{
+    if (!cola || !elementos)
+        return 0;
+    size_t desencolar = atomic_load_explicit(&cola->posicion_desencolar, memory_order_relaxed);
+    size_t disponibles = cola->encolar_conocida - desencolar;
+    if (disponibles < cantidad)
+    {
+        cola->encolar_conocida =
+            atomic_load_explicit(&cola->posicion_encolar, memory_order_acquire);
+        disponibles = cola->encolar_conocida - desencolar;
+    }
+    if (cantidad > disponibles)
+        cantidad = disponibles;
+    for (size_t i = 0; i < cantidad; i++)
+        elementos[i] = cola->datos[(desencolar + i) & cola->mascara];
+    atomic_store_explicit(&cola->posicion_desencolar, desencolar + cantidad,
+                          memory_order_release);
+    return cantidad;
+}
+
+/*
+ * Encola un elemento. Solo desde el hilo productor.
+ * Devuelve 0 si pudo encolar o -1 si la cola esta llena.
+ */
+int cola_spsc_encolar(cola_spsc_t* cola, void* elemento)
+{
+    return cola_spsc_encolar_varios(cola, &elemento, 1) == 1 ? 0 : -1;
+}
+
+/*
+ * Desencola un elemento y lo guarda en elemento. Solo desde el hilo
+ * consumidor.
+ * Devuelve 0 si pudo desencolar o -1 si la cola esta vacia.
+ */
+int cola_spsc_desencolar(cola_spsc_t* cola, void** elemento)
+{
+    return cola_spsc_desencolar_varios(cola, elemento, 1) == 1 ? 0 : -1;
+}
+
+/*
+ * Devuelve el primer elemento de la cola o NULL en caso de estar
+ * vacía. Solo desde el hilo consumidor.
+ */
+void* cola_spsc_primero(cola_spsc_t* cola)
+{
+    if (!cola)
+        return NULL;
+    size_t desencolar = atomic_load_explicit(&cola->posicion_desencolar, memory_order_relaxed);
+    if (cola->encolar_conocida == desencolar)
+        cola->encolar_conocida =
+            atomic_load_explicit(&cola->posicion_encolar, memory_order_acquire);
+    if (cola->encolar_conocida == desencolar)
+        return NULL;
+    return cola->datos[desencolar & cola->mascara];
+}
+
+/*
+ * Devuelve la cantidad de elementos en la cola. Si el otro hilo la esta
+ * modificando, el valor es aproximado.
+ */
+size_t cola_spsc_elementos(cola_spsc_t* cola)
+{
+    if (!cola)
+        return 0;
+    size_t desencolar = atomic_load_explicit(&cola->posicion_desencolar, memory_order_acquire);
+    size_t encolar = atomic_load_explicit(&cola->posicion_encolar, memory_order_acquire);
+    return encolar - desencolar;
+}
+
+/*
+ * Devuelve true si la cola está vacía o false en caso contrario. Si el
+ * otro hilo la esta modificando, el valor es aproximado.
+ */
+bool cola_spsc_vacia(cola_spsc_t* cola)
+{
+    return (cola_spsc_elementos(cola) == 0);
+}
+
+/*
+ * Libera la memoria reservada por la cola. Ningun hilo puede estar
+ * usandola.
+ */
+void cola_spsc_destruir(cola_spsc_t* cola)
+{
+    if (!cola)
+        return;
+    free(cola->datos);
+    free(cola);
+}
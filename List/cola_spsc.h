@@ -0,0 +1,77 @@
+#ifndef __COLA_SPSC_H__
+#define __COLA_SPSC_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Cola acotada para exactamente un hilo productor y un hilo consumidor.
+ * Ninguna operacion espera al otro hilo: cada uno escribe solo su propia
+ * posicion del vector circular y lee la del otro.
+ *
+ * Encolar y las operaciones de varios elementos para encolar solo pueden
+ * usarse desde el hilo productor. Desencolar, primero y las de varios
+ * elementos para desencolar, solo desde el hilo consumidor.
+ */
+typedef struct cola_spsc cola_spsc_t;
+
+/*
+ * Crea la cola reservando la memoria necesaria. La capacidad se redondea
+ * a la potencia de 2 siguiente.
+ * Devuelve un puntero a la cola creada o NULL en caso de error.
+ */
+cola_spsc_t* cola_spsc_crear(size_t capacidad);
+
+/*
+ * Encola un elemento. Solo desde el hilo productor.
+ * Devuelve 0 si pudo encolar o -1 si la cola esta llena.
+ */
+int cola_spsc_encolar(cola_spsc_t* cola, void* elemento);
+
+/*
+ * Desencola un elemento y lo guarda en elemento. Solo desde el hilo
+ * consumidor.
+ * Devuelve 0 si pudo desencolar o -1 si la cola esta vacia.
+ */
+int cola_spsc_desencolar(cola_spsc_t* cola, void** elemento);
+
+/*
+ * Devuelve el primer elemento de la cola o NULL en caso de estar
+ * vacía. Solo desde el hilo consumidor.
+ */
+void* cola_spsc_primero(cola_spsc_t* cola);
+
+/*
+ * Encola en orden la mayor cantidad posible de los elementos del
+ * vector. Solo desde el hilo productor.
+ * Devuelve la cantidad de elementos encolados (0 si la cola esta llena).
+ */
+size_t cola_spsc_encolar_varios(cola_spsc_t* cola, void** elementos, size_t cantidad);
+
+/*
+ * Desencola hasta cantidad elementos y los guarda en orden en el
+ * vector. Solo desde el hilo consumidor.
+ * Devuelve la cantidad de elementos desencolados (0 si la cola esta
+ * vacia).
+ */
+size_t cola_spsc_desencolar_varios(cola_spsc_t* cola, void** elementos, size_t cantidad);
+
+/*
+ * Devuelve la cantidad de elementos en la cola. Si el otro hilo la esta
+ * modificando, el valor es aproximado.
+ */
+size_t cola_spsc_elementos(cola_spsc_t* cola);
+
+/*
+ * Devuelve true si la cola está vacía o false en caso contrario. Si el
+ * otro hilo la esta modificando, el valor es aproximado.
+ */
+bool cola_spsc_vacia(cola_spsc_t* cola);
+
+/*
+ * Libera la memoria reservada por la cola. Ningun hilo puede estar
+ * usandola.
+ */
+void cola_spsc_destruir(cola_spsc_t* cola);
+
+#endif /* __COLA_SPSC_H__ */
@@ -1,19 +1,30 @@
 #include "lista.h"
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 
+#include "pool_nodos.h"
+
+#define NIVELES_ORDENAR 64    // Cadenas ordenadas de 2^i nodos, alcanza para cualquier largo
+#define MINIMO_POR_HILO 16384 // Elementos por hilo por debajo de los cuales no conviene repartir
+
 typedef struct nodo
 {
     void*        dato;
     struct nodo* siguiente;
+    struct nodo* anterior;
 } nodo_t;
 
 struct lista
 {
-    nodo_t* head;
-    size_t  largo;
+    nodo_t*       head;
+    nodo_t*       tail;
+    size_t        largo;
+    nodo_t*       dedo; // Ultimo nodo accedido por posicion, o NULL
+    size_t        posicion_dedo;
+    pool_nodos_t* pool; // De donde salen los nodos de la lista
 };
 
 struct lista_iterador
@@ -23,21 +34,115 @@ struct lista_iterador
 
 lista_t* lista_crear()
 {
-    return calloc(1, sizeof(lista_t));
+    lista_t* lista = calloc(1, sizeof(lista_t));
+    if (!lista)
+        return NULL;
+    lista->pool = pool_crear(sizeof(nodo_t));
+    if (!lista->pool)
+    {
+        free(lista);
+        return NULL;
+    }
+    return lista;
 }
 
 /*
- * Crea un nuevo nodo, con elemento como dato, apunta a NULL
+ * Crea un nuevo nodo desde el pool de la lista, con elemento como dato,
+ * apunta a NULL
  * Devuelve un puntero a un nodo, o NULL en caso de fallar
  */
-static nodo_t* nuevo_nodo(void* elemento)
+static nodo_t* nuevo_nodo(lista_t* lista, void* elemento)
 {
-    nodo_t* nodo = calloc(1, sizeof(nodo_t));
+    nodo_t* nodo = pool_reservar(lista->pool);
     if (!nodo)
         return NULL;
     nodo->dato = elemento;
     return nodo;
 }
+
+/*
+ * Engancha el nodo en la lista antes de siguiente, o al final si
+ * siguiente es NULL. Posicion es la que ocupa el nodo una vez enganchado,
+ * y el dedo pasa a ser el nodo nuevo.
+ */
+static void enlazar(lista_t* lista, nodo_t* nodo, nodo_t* siguiente, size_t posicion)
+{
+    nodo->siguiente = siguiente;
+    nodo->anterior = siguiente ? siguiente->anterior : lista->tail;
+    if (nodo->anterior)
+        nodo->anterior->siguiente = nodo;
+    else
+        lista->head = nodo;
+    if (siguiente)
+        siguiente->anterior = nodo;
+    else
+        lista->tail = nodo;
+    lista->largo++;
+    lista->dedo = nodo;
+    lista->posicion_dedo = posicion;
+}
+
+/*
+ * Desengancha el nodo de la lista, sin liberarlo. Posicion es la que
+ * ocupaba el nodo, y se usa para mantener valido el dedo.
+ */
+static void desenlazar(lista_t* lista, nodo_t* nodo, size_t posicion)
+{
+    // Si se quita el dedo pasa al siguiente, que queda en su misma posicion, o al anterior
+    if (lista->dedo == nodo)
+    {
+        lista->dedo = nodo->siguiente ? nodo->siguiente : nodo->anterior;
+        if (!nodo->siguiente)
+            lista->posicion_dedo--;
+    }
+    else if (lista->dedo && posicion < lista->posicion_dedo)
+        lista->posicion_dedo--;
+    if (nodo->anterior)
+        nodo->anterior->siguiente = nodo->siguiente;
+    else
+        lista->head = nodo->siguiente;
+    if (nodo->siguiente)
+        nodo->siguiente->anterior = nodo->anterior;
+    else
+        lista->tail = nodo->anterior;
+    lista->largo--;
+}
+
+/*
+ * Devuelve el nodo en la posicion indicada, que debe existir. Camina
+ * desde el mas cercano entre el principio, el final y el dedo, y deja el
+ * dedo en el nodo encontrado, asi los accesos a posiciones cercanas
+ * entre si no recorren la lista.
+ */
+static nodo_t* nodo_en_posicion(lista_t* lista, size_t posicion)
+{
+    nodo_t* tracker = lista->head;
+    size_t  actual = 0;
+    if (lista->largo - 1 - posicion < posicion)
+    {
+        tracker = lista->tail;
+        actual = lista->largo - 1;
+    }
+    if (lista->dedo)
+    {
+        size_t distancia = posicion > actual ? posicion - actual : actual - posicion;
+        size_t distancia_dedo = posicion > lista->posicion_dedo ? posicion - lista->posicion_dedo
+                                                                : lista->posicion_dedo - posicion;
+        if (distancia_dedo < distancia)
+        {
+            tracker = lista->dedo;
+            actual = lista->posicion_dedo;
+        }
+    }
+    for (; actual < posicion; actual++)
+        tracker = tracker->siguiente;
+    for (; actual > posicion; actual--)
+        tracker = tracker->anterior;
+    lista->dedo = tracker;
+    lista->posicion_dedo = posicion;
+    return tracker;
+}
+
 /*
  * Inserta un elemento al final de la lista.
  * Devuelve 0 si pudo insertar o -1 si no pudo.
@@ -46,19 +151,10 @@ int lista_insertar(lista_t* lista, void* elemento)
 {
     if (!lista)
         return -1;
-    nodo_t* tracker = lista->head;
-    nodo_t* auxiliar = nuevo_nodo(elemento);
+    nodo_t* auxiliar = nuevo_nodo(lista, elemento);
     if (!auxiliar)
         return -1;
-    if (tracker)
-    {
-        while (tracker->siguiente)
-            tracker = tracker->siguiente;
-        tracker->siguiente = auxiliar;
-    }
-    else
-        lista->head = auxiliar;
-    lista->largo++;
+    enlazar(lista, auxiliar, NULL, lista->largo);
     return 0;
 }
 
@@ -74,36 +170,71 @@ int lista_insertar_en_posicion(lista_t* lista, void* elemento, size_t posicion)
         return -1;
     if (posicion >= lista->largo || lista_vacia(lista))
         return lista_insertar(lista, elemento);
-    nodo_t* anterior = NULL;
-    nodo_t* tracker = lista->head;
-    nodo_t* auxiliar = nuevo_nodo(elemento);
+    nodo_t* auxiliar = nuevo_nodo(lista, elemento);
     if (!auxiliar)
         return -1;
-    for (int i = 0; i < posicion; i++)
-    {
-        anterior = tracker;
-        tracker = tracker->siguiente;
-    }
-    if (anterior)
-    {
-        anterior->siguiente = auxiliar;
-        auxiliar->siguiente = tracker;
-    }
-    else
+    enlazar(lista, auxiliar, nodo_en_posicion(lista, posicion), posicion);
+    return 0;
+}
+/*
+ *Devuelve el nodo al pool de la lista para que pueda ser reutilizado
+ */
+static void liberar_nodo(lista_t* lista, nodo_t* nodo)
+{
+    pool_liberar(lista->pool, nodo);
+}
+/*
+ * Devuelve al pool los nodos encadenados por siguiente desde nodo.
+ */
+static void liberar_cadena(pool_nodos_t* pool, nodo_t* nodo)
+{
+    while (nodo)
     {
-        auxiliar->siguiente = tracker;
-        lista->head = auxiliar;
+        nodo_t* siguiente = nodo->siguiente;
+        pool_liberar(pool, nodo);
+        nodo = siguiente;
     }
-    lista->largo++;
-    return 0;
 }
+
 /*
- *Libera la memoria reservada para un nodo
+ * Inserta al final de la lista, en orden, los elementos del arreglo.
+ * Devuelve 0 si pudo insertarlos todos o -1 si no pudo, en cuyo caso la
+ * lista queda como estaba.
  */
-static void liberar_nodo(nodo_t* nodo)
+int lista_insertar_arreglo(lista_t* lista, void** elementos, size_t cantidad)
 {
-    free(nodo);
+    if (!lista || (!elementos && cantidad))
+        return -1;
+    // Los nodos se encadenan aparte y se enganchan todos juntos al final
+    nodo_t* primero = NULL;
+    nodo_t* ultimo = NULL;
+    for (size_t i = 0; i < cantidad; i++)
+    {
+        nodo_t* nodo = nuevo_nodo(lista, elementos[i]);
+        if (!nodo)
+        {
+            liberar_cadena(lista->pool, primero);
+            return -1;
+        }
+        nodo->anterior = ultimo;
+        if (ultimo)
+            ultimo->siguiente = nodo;
+        else
+            primero = nodo;
+        ultimo = nodo;
+    }
+    if (!primero)
+        return 0;
+    primero->anterior = lista->tail;
+    if (lista->tail)
+        lista->tail->siguiente = primero;
+    else
+        lista->head = primero;
+    lista->tail = ultimo;
+    lista->largo += cantidad;
+    return 0;
 }
+
 /*
  * Quita de la lista el elemento que se encuentra en la ultima posición.
  * Devuelve 0 si pudo eliminar o -1 si no pudo.
@@ -112,19 +243,9 @@ int lista_borrar(lista_t* lista)
 {
     if (!lista || lista_vacia(lista))
         return -1;
-    nodo_t* anterior = NULL;
-    nodo_t* tracker = lista->head;
-    while (tracker->siguiente)
-    {
-        anterior = tracker;
-        tracker = tracker->siguiente;
-    }
-    if (anterior)
-        anterior->siguiente = NULL;
-    else
-        lista->head = NULL;
-    liberar_nodo(tracker);
-    lista->largo--;
+    nodo_t* tracker = lista->tail;
+    desenlazar(lista, tracker, lista->largo - 1);
+    liberar_nodo(lista, tracker);
     return 0;
 }
 
@@ -141,19 +262,9 @@ int lista_borrar_de_posicion(lista_t* lista, size_t posicion)
         return -1;
     if (posicion >= lista->largo)
         return lista_borrar(lista);
-    nodo_t* anterior = NULL;
-    nodo_t* tracker = lista->head;
-    for (int i = 0; i < posicion; i++)
-    {
-        anterior = tracker;
-        tracker = tracker->siguiente;
-    }
-    if (anterior)
-        anterior->siguiente = tracker->siguiente;
-    else
-        lista->head = tracker->siguiente;
-    liberar_nodo(tracker);
-    lista->largo--;
+    nodo_t* tracker = nodo_en_posicion(lista, posicion);
+    desenlazar(lista, tracker, posicion);
+    liberar_nodo(lista, tracker);
     return 0;
 }
 
@@ -167,10 +278,29 @@ void* lista_elemento_en_posicion(lista_t* lista, size_t posicion)
 {
     if (!lista || posicion >= lista_elementos(lista))
         return NULL;
+    return nodo_en_posicion(lista, posicion)->dato;
+}
+
+/*
+ * Llena el arreglo del tamaño dado con los elementos de la lista, en
+ * orden.
+ * Devuelve la cantidad de elementos del arreglo que pudo llenar (si el
+ * espacio en el arreglo no alcanza para almacenar todos los elementos,
+ * llena hasta donde puede y devuelve la cantidad de elementos que
+ * pudo poner).
+ */
+size_t lista_a_arreglo(lista_t* lista, void** arreglo, size_t tamanio_arreglo)
+{
+    if (!lista || !arreglo)
+        return 0;
+    size_t  cantidad = 0;
     nodo_t* tracker = lista->head;
-    for (int i = 0; i < posicion; i++)
+    while (tracker && cantidad < tamanio_arreglo)
+    {
+        arreglo[cantidad++] = tracker->dato;
         tracker = tracker->siguiente;
-    return tracker->dato;
+    }
+    return cantidad;
 }
 
 /*
@@ -183,10 +313,7 @@ void* lista_ultimo(lista_t* lista)
         return NULL;
     if (lista_vacia(lista))
         return NULL;
-    nodo_t* tracker = lista->head;
-    while (tracker->siguiente)
-        tracker = tracker->siguiente;
-    return tracker->dato;
+    return lista->tail->dato;
 }
 
 /*
@@ -229,7 +356,7 @@ int lista_desapilar(lista_t* lista)
  */
 void* lista_tope(lista_t* lista)
 {
-    return lista_elemento_en_posicion(lista, lista_elementos(lista) - 1);
+    return lista_ultimo(lista);
 }
 
 /*
@@ -259,6 +386,312 @@ void* lista_primero(lista_t* lista)
     return lista_tope(lista);
 }
 
+/*
+ * Lleva los nodos de la lista origen al pool de destino. Si el pool de
+ * origen no es compartido, destino absorbe sus bloques sin recorrer los
+ * nodos y origen sigue con un pool nuevo. Si no, o si no puede
+ * absorberlos, los nodos se copian uno por uno.
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso nada cambia.
+ */
+static int mudar_nodos(lista_t* destino, lista_t* origen)
+{
+    if (destino->pool == origen->pool)
+        return 0;
+    if (!pool_es_compartido(origen->pool))
+    {
+        // Origen no pasa a compartir el pool de destino, asi puede seguir usandose desde otro hilo
+        pool_nodos_t* pool = pool_crear(sizeof(nodo_t));
+        if (!pool)
+            return -1;
+        if (pool_absorber(destino->pool, origen->pool) == 0)
+        {
+            origen->pool = pool;
+            return 0;
+        }
+        pool_destruir(pool);
+    }
+    // Se reservan todas las copias antes de tocar la lista, encadenadas por siguiente
+    nodo_t* copias = NULL;
+    for (size_t i = 0; i < origen->largo; i++)
+    {
+        nodo_t* copia = pool_reservar(destino->pool);
+        if (!copia)
+        {
+            liberar_cadena(destino->pool, copias);
+            return -1;
+        }
+        copia->siguiente = copias;
+        copias = copia;
+    }
+    nodo_t* anterior = NULL;
+    nodo_t* tracker = origen->head;
+    while (tracker)
+    {
+        nodo_t* copia = copias;
+        copias = copias->siguiente;
+        copia->dato = tracker->dato;
+        copia->anterior = anterior;
+        copia->siguiente = NULL;
+        if (anterior)
+            anterior->siguiente = copia;
+        else
+            origen->head = copia;
+        anterior = copia;
+        nodo_t* siguiente = tracker->siguiente;
+        pool_liberar(origen->pool, tracker);
+        tracker = siguiente;
+    }
+    origen->tail = anterior;
+    origen->dedo = NULL;
+    return 0;
+}
+
+/*
+ * Mueve todos los elementos de origen al final de destino, sin recorrer
+ * la lista si origen no comparte sus nodos con otra lista. Origen queda
+ * vacía.
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso nada cambia.
+ */
+int lista_concatenar(lista_t* destino, lista_t* origen)
+{
+    if (!destino || !origen || destino == origen)
+        return -1;
+    if (lista_vacia(origen))
+        return 0;
+    if (mudar_nodos(destino, origen) == -1)
+        return -1;
+    origen->head->anterior = destino->tail;
+    if (destino->tail)
+        destino->tail->siguiente = origen->head;
+    else
+        destino->head = origen->head;
+    destino->tail = origen->tail;
+    destino->largo += origen->largo;
+    origen->head = NULL;
+    origen->tail = NULL;
+    origen->dedo = NULL;
+    origen->largo = 0;
+    return 0;
+}
+
+/*
+ * Quita de la lista los elementos desde la posicion indicada hasta el
+ * final y los devuelve en una lista nueva, en orden. Si no existe la
+ * posicion, la lista nueva queda vacía.
+ * La lista nueva comparte los nodos con la original, por lo que no
+ * pueden usarse las dos desde hilos distintos a la vez.
+ * Devuelve la lista nueva o NULL en caso de error.
+ */
+lista_t* lista_cortar(lista_t* lista, size_t posicion)
+{
+    if (!lista)
+        return NULL;
+    lista_t* resto = calloc(1, sizeof(lista_t));
+    if (!resto)
+        return NULL;
+    resto->pool = pool_compartir(lista->pool);
+    if (posicion >= lista->largo)
+        return resto;
+    nodo_t* primero = nodo_en_posicion(lista, posicion);
+    resto->head = primero;
+    resto->tail = lista->tail;
+    resto->largo = lista->largo - posicion;
+    resto->dedo = primero;
+    lista->tail = primero->anterior;
+    if (lista->tail)
+        lista->tail->siguiente = NULL;
+    else
+        lista->head = NULL;
+    primero->anterior = NULL;
+    lista->largo = posicion;
+    lista->dedo = lista->tail;
+    lista->posicion_dedo = lista->tail ? posicion - 1 : 0;
+    return resto;
+}
+
+/*
+ * Mezcla dos cadenas ordenadas, enlazadas solo por siguiente y
+ * terminadas en NULL. Ante elementos iguales va primero el de a.
+ * Devuelve la cadena mezclada.
+ */
+static nodo_t* mezclar(nodo_t* a, nodo_t* b, lista_comparador comparador)
+{
+    nodo_t  cabeza = {0};
+    nodo_t* ultimo = &cabeza;
+    while (a && b)
+    {
+        if (comparador(b->dato, a->dato) < 0)
+        {
+            ultimo->siguiente = b;
+            b = b->siguiente;
+        }
+        else
+        {
+            ultimo->siguiente = a;
+            a = a->siguiente;
+        }
+        ultimo = ultimo->siguiente;
+    }
+    ultimo->siguiente = a ? a : b;
+    return cabeza.siguiente;
+}
+
+/*
+ * Ordena una cadena enlazada solo por siguiente y terminada en NULL,
+ * con merge sort de abajo hacia arriba: cada nodo se mezcla con las
+ * cadenas ya ordenadas de 1, 2, 4... nodos mientras esten ocupadas.
+ * Devuelve la cadena ordenada.
+ */
+static nodo_t* ordenar_cadena(nodo_t* cadena, lista_comparador comparador)
+{
+    nodo_t* niveles[NIVELES_ORDENAR] = {0};
+    while (cadena)
+    {
+        nodo_t* actual = cadena;
+        cadena = cadena->siguiente;
+        actual->siguiente = NULL;
+        size_t nivel = 0;
+        // Los niveles tienen nodos anteriores a actual, por eso van primero al mezclar
+        for (; nivel < NIVELES_ORDENAR - 1 && niveles[nivel]; nivel++)
+        {
+            actual = mezclar(niveles[nivel], actual, comparador);
+            niveles[nivel] = NULL;
+        }
+        niveles[nivel] = mezclar(niveles[nivel], actual, comparador);
+    }
+    nodo_t* ordenada = NULL;
+    for (size_t nivel = 0; nivel < NIVELES_ORDENAR; nivel++)
+        ordenada = mezclar(niveles[nivel], ordenada, comparador);
+    return ordenada;
+}
+
+/*
+ * Vuelve a armar la lista a partir de la cadena, recuperando los
+ * enlaces anteriores y el final.
+ */
+static void reenlazar(lista_t* lista, nodo_t* cadena)
+{
+    nodo_t* anterior = NULL;
+    lista->head = cadena;
+    for (nodo_t* tracker = cadena; tracker; tracker = tracker->siguiente)
+    {
+        tracker->anterior = anterior;
+        anterior = tracker;
+    }
+    lista->tail = anterior;
+    lista->dedo = NULL;
+}
+
+/*
+ * Ordena la lista de menor a mayor segun el comparador, reenlazando los
+ * nodos (merge sort, sin reservar memoria). Los elementos iguales
+ * mantienen su orden relativo.
+ * Devuelve 0 si pudo ordenar o -1 si no pudo.
+ */
+int lista_ordenar(lista_t* lista, lista_comparador comparador)
+{
+    if (!lista || !comparador)
+        return -1;
+    reenlazar(lista, ordenar_cadena(lista->head, comparador));
+    return 0;
+}
+
+/*
+ * Una tarea ordena la cadena a, o si b no es NULL, mezcla las cadenas
+ * ordenadas a y b. El resultado queda en a.
+ */
+typedef struct tarea_orden
+{
+    nodo_t*          a;
+    nodo_t*          b;
+    lista_comparador comparador;
+} tarea_orden_t;
+
+static void* ordenar_tarea(void* tarea_orden)
+{
+    tarea_orden_t* tarea = tarea_orden;
+    if (tarea->b)
+        tarea->a = mezclar(tarea->a, tarea->b, tarea->comparador);
+    else
+        tarea->a = ordenar_cadena(tarea->a, tarea->comparador);
+    tarea->b = NULL;
+    return NULL;
+}
+
+/*
+ * Ejecuta las tareas, cada una en un hilo nuevo salvo la primera, que
+ * se ejecuta en el hilo que llama. Las tareas cuyo hilo no se pudo
+ * crear tambien se ejecutan en el hilo que llama.
+ */
+static void ejecutar_tareas(tarea_orden_t* tareas, size_t cantidad)
+{
+    pthread_t* ids = malloc(cantidad * sizeof(pthread_t));
+    size_t     creados = 0;
+    for (size_t i = 1; i < cantidad; i++)
+        if (ids && pthread_create(&ids[creados], NULL, ordenar_tarea, &tareas[i]) == 0)
+            creados++;
+        else
+            ordenar_tarea(&tareas[i]);
+    ordenar_tarea(&tareas[0]);
+    for (size_t i = 0; i < creados; i++)
+        pthread_join(ids[i], NULL);
+    free(ids);
+}
+
+/*
+ * Igual que lista_ordenar, pero parte la lista en tramos que ordena con
+ * la cantidad de hilos indicada (el hilo que llama es uno de ellos) y
+ * luego los mezcla. Si no se pueden crear todos los hilos, se trabaja
+ * con los que se hayan podido crear. El comparador es invocado desde
+ * varios hilos a la vez y debe ser seguro para ello.
+ * Devuelve 0 si pudo ordenar o -1 si no pudo.
+ */
+int lista_ordenar_paralelo(lista_t* lista, lista_comparador comparador, size_t hilos)
+{
+    if (!lista || !comparador)
+        return -1;
+    if (hilos > lista->largo / MINIMO_POR_HILO)
+        hilos = lista->largo / MINIMO_POR_HILO;
+    tarea_orden_t* tareas = hilos > 1 ? malloc(hilos * sizeof(tarea_orden_t)) : NULL;
+    if (!tareas)
+        return lista_ordenar(lista, comparador);
+
+    // Se corta la lista en tramos consecutivos de igual largo, el ultimo con el sobrante
+    nodo_t* tracker = lista->head;
+    for (size_t i = 0; i < hilos; i++)
+    {
+        tareas[i] = (tarea_orden_t){tracker, NULL, comparador};
+        if (i == hilos - 1)
+            break;
+        for (size_t j = 1; j < lista->largo / hilos; j++)
+            tracker = tracker->siguiente;
+        nodo_t* siguiente = tracker->siguiente;
+        tracker->siguiente = NULL;
+        tracker = siguiente;
+    }
+    ejecutar_tareas(tareas, hilos);
+
+    // Los tramos se mezclan de a pares vecinos, asi se mantiene el orden de los iguales
+    size_t cantidad = hilos;
+    while (cantidad > 1)
+    {
+        size_t  pares = cantidad / 2;
+        nodo_t* suelto = cantidad % 2 ? tareas[cantidad - 1].a : NULL;
+        for (size_t i = 0; i < pares; i++)
+        {
+            tareas[i].a = tareas[2 * i].a;
+            tareas[i].b = tareas[2 * i + 1].a;
+        }
+        ejecutar_tareas(tareas, pares);
+        if (suelto)
+            tareas[pares++].a = suelto;
+        cantidad = pares;
+    }
+    reenlazar(lista, tareas[0].a);
+    free(tareas);
+    return 0;
+}
+
 /*
  * Libera la memoria reservada por la lista.
  */
@@ -266,8 +699,11 @@ void lista_destruir(lista_t* lista)
 {
     if (!lista)
         return;
-    while (!lista_vacia(lista))
-        lista_borrar(lista);
+    // Los nodos se liberan junto con los bloques del pool, sin recorrer la lista,
+    // salvo que otra lista siga usando el pool
+    if (pool_es_compartido(lista->pool))
+        liberar_cadena(lista->pool, lista->head);
+    pool_destruir(lista->pool);
     free(lista);
 }
 
@@ -332,6 +768,140 @@ void lista_iterador_destruir(lista_iterador_t* iterador)
     free(iterador);
 }
 
+/*
+ * Devuelve un cursor sobre el primer elemento de la lista, o fuera de
+ * la lista si esta vacía.
+ */
+lista_cursor_t lista_cursor_inicio(lista_t* lista)
+{
+    lista_cursor_t cursor = {.lista = lista};
+    if (lista)
+        cursor.actual = lista->head;
+    return cursor;
+}
+
+/*
+ * Devuelve un cursor sobre el último elemento de la lista, o fuera de
+ * la lista si esta vacía.
+ */
+lista_cursor_t lista_cursor_final(lista_t* lista)
+{
+    lista_cursor_t cursor = {.lista = lista};
+    if (lista && !lista_vacia(lista))
+    {
+        cursor.actual = lista->tail;
+        cursor.posicion = lista->largo - 1;
+    }
+    return cursor;
+}
+
+/*
+ * Devuelve true si el cursor esta sobre un elemento o false si esta
+ * fuera de la lista.
+ */
+bool lista_cursor_valido(lista_cursor_t* cursor)
+{
+    return cursor && cursor->actual;
+}
+
+/*
+ * Devuelve el elemento sobre el que esta el cursor o NULL si esta fuera
+ * de la lista.
+ */
+void* lista_cursor_actual(lista_cursor_t* cursor)
+{
+    if (!lista_cursor_valido(cursor))
+        return NULL;
+    return cursor->actual->dato;
+}
+
+/*
+ * Devuelve la posicion del elemento sobre el que esta el cursor, o la
+ * cantidad de elementos de la lista si esta fuera de la misma.
+ */
+size_t lista_cursor_posicion(lista_cursor_t* cursor)
+{
+    if (!cursor)
+        return 0;
+    if (!cursor->actual)
+        return lista_elementos(cursor->lista);
+    return cursor->posicion;
+}
+
+/*
+ * Mueve el cursor al elemento siguiente. Desde el último sale de la
+ * lista y desde fuera de la lista pasa al primero.
+ * Devuelve true si quedo sobre un elemento o false en caso contrario.
+ */
+bool lista_cursor_siguiente(lista_cursor_t* cursor)
+{
+    if (!cursor || !cursor->lista)
+        return false;
+    if (!cursor->actual)
+    {
+        *cursor = lista_cursor_inicio(cursor->lista);
+        return lista_cursor_valido(cursor);
+    }
+    cursor->actual = cursor->actual->siguiente;
+    cursor->posicion++;
+    return lista_cursor_valido(cursor);
+}
+
+/*
+ * Mueve el cursor al elemento anterior. Desde el primero sale de la
+ * lista y desde fuera de la lista pasa al último.
+ * Devuelve true si quedo sobre un elemento o false en caso contrario.
+ */
+bool lista_cursor_anterior(lista_cursor_t* cursor)
+{
+    if (!cursor || !cursor->lista)
+        return false;
+    if (!cursor->actual)
+    {
+        *cursor = lista_cursor_final(cursor->lista);
+        return lista_cursor_valido(cursor);
+    }
+    cursor->actual = cursor->actual->anterior;
+    cursor->posicion--;
+    return lista_cursor_valido(cursor);
+}
+
+/*
+ * Inserta un elemento antes del elemento actual, o al final de la lista
+ * si el cursor esta fuera de la misma. El cursor sigue sobre el mismo
+ * elemento.
+ * Devuelve 0 si pudo insertar o -1 si no pudo.
+ */
+int lista_cursor_insertar_aqui(lista_cursor_t* cursor, void* elemento)
+{
+    if (!cursor || !cursor->lista)
+        return -1;
+    lista_t* lista = cursor->lista;
+    nodo_t*  auxiliar = nuevo_nodo(lista, elemento);
+    if (!auxiliar)
+        return -1;
+    enlazar(lista, auxiliar, cursor->actual, lista_cursor_posicion(cursor));
+    if (cursor->actual)
+        cursor->posicion++;
+    return 0;
+}
+
+/*
+ * Quita de la lista el elemento actual y mueve el cursor al siguiente,
+ * o fuera de la lista si era el último.
+ * Devuelve 0 si pudo eliminar o -1 si no pudo.
+ */
+int lista_cursor_borrar_actual(lista_cursor_t* cursor)
+{
+    if (!lista_cursor_valido(cursor) || !cursor->lista)
+        return -1;
+    nodo_t* tracker = cursor->actual;
+    cursor->actual = tracker->siguiente;
+    desenlazar(cursor->lista, tracker, cursor->posicion);
+    liberar_nodo(cursor->lista, tracker);
+    return 0;
+}
+
 /*
  * Iterador interno. Recorre la lista e invoca la funcion con cada
  * elemento de la misma.
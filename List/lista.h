@@ -4,9 +4,32 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/*
+ * Comparador de elementos. Recibe dos elementos de la lista y devuelve
+ * 0 en caso de ser iguales, un numero positivo si el primer elemento es
+ * mayor al segundo o negativo si el primer elemento es menor al segundo.
+ */
+typedef int (*lista_comparador)(void*, void*);
+
 typedef struct lista lista_t;
 typedef struct lista_iterador lista_iterador_t;
 
+/*
+ * Cursor sobre una lista, pensado para declararse en el stack. Puede
+ * moverse en ambos sentidos y agregar o quitar elementos en su posicion
+ * en O(1). Fuera de la lista (actual NULL) esta a la vez despues del
+ * ultimo elemento y antes del primero.
+ *
+ * Es válido mientras la lista solo se modifique a traves del mismo
+ * cursor. Los campos no deben modificarse directamente.
+ */
+typedef struct lista_cursor
+{
+    lista_t*     lista;
+    struct nodo* actual;
+    size_t       posicion;
+} lista_cursor_t;
+
 /*
  * Crea la lista reservando la memoria necesaria.
  * Devuelve un puntero a la lista creada o NULL en caso de error.
@@ -27,6 +50,13 @@ int lista_insertar(lista_t* lista, void* elemento);
  */
 int lista_insertar_en_posicion(lista_t* lista, void* elemento, size_t posicion);
 
+/*
+ * Inserta al final de la lista, en orden, los elementos del arreglo.
+ * Devuelve 0 si pudo insertarlos todos o -1 si no pudo, en cuyo caso la
+ * lista queda como estaba.
+ */
+int lista_insertar_arreglo(lista_t* lista, void** elementos, size_t cantidad);
+
 /*
  * Quita de la lista el elemento que se encuentra en la ultima posición.
  * Devuelve 0 si pudo eliminar o -1 si no pudo.
@@ -50,6 +80,16 @@ int lista_borrar_de_posicion(lista_t* lista, size_t posicion);
  */
 void* lista_elemento_en_posicion(lista_t* lista, size_t posicion);
 
+/*
+ * Llena el arreglo del tamaño dado con los elementos de la lista, en
+ * orden.
+ * Devuelve la cantidad de elementos del arreglo que pudo llenar (si el
+ * espacio en el arreglo no alcanza para almacenar todos los elementos,
+ * llena hasta donde puede y devuelve la cantidad de elementos que
+ * pudo poner).
+ */
+size_t lista_a_arreglo(lista_t* lista, void** arreglo, size_t tamanio_arreglo);
+
 /* 
  * Devuelve el último elemento de la lista o NULL si la lista se
  * encuentra vacía.
@@ -102,6 +142,42 @@ int lista_desencolar(lista_t* lista);
  */
 void* lista_primero(lista_t* lista);
 
+/*
+ * Mueve todos los elementos de origen al final de destino, sin recorrer
+ * la lista si origen no comparte sus nodos con otra lista. Origen queda
+ * vacía.
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso nada cambia.
+ */
+int lista_concatenar(lista_t* destino, lista_t* origen);
+
+/*
+ * Quita de la lista los elementos desde la posicion indicada hasta el
+ * final y los devuelve en una lista nueva, en orden. Si no existe la
+ * posicion, la lista nueva queda vacía.
+ * La lista nueva comparte los nodos con la original, por lo que no
+ * pueden usarse las dos desde hilos distintos a la vez.
+ * Devuelve la lista nueva o NULL en caso de error.
+ */
+lista_t* lista_cortar(lista_t* lista, size_t posicion);
+
+/*
+ * Ordena la lista de menor a mayor segun el comparador, reenlazando los
+ * nodos (merge sort, sin reservar memoria). Los elementos iguales
+ * mantienen su orden relativo.
+ * Devuelve 0 si pudo ordenar o -1 si no pudo.
+ */
+int lista_ordenar(lista_t* lista, lista_comparador comparador);
+
+/*
+ * Igual que lista_ordenar, pero parte la lista en tramos que ordena con
+ * la cantidad de hilos indicada (el hilo que llama es uno de ellos) y
+ * luego los mezcla. Si no se pueden crear todos los hilos, se trabaja
+ * con los que se hayan podido crear. El comparador es invocado desde
+ * varios hilos a la vez y debe ser seguro para ello.
+ * Devuelve 0 si pudo ordenar o -1 si no pudo.
+ */
+int lista_ordenar_paralelo(lista_t* lista, lista_comparador comparador, size_t hilos);
+
 /*
  * Libera la memoria reservada por la lista.
  */
@@ -134,6 +210,65 @@ void* lista_iterador_siguiente(lista_iterador_t* iterador);
  */
 void lista_iterador_destruir(lista_iterador_t* iterador);
 
+/*
+ * Devuelve un cursor sobre el primer elemento de la lista, o fuera de
+ * la lista si esta vacía.
+ */
+lista_cursor_t lista_cursor_inicio(lista_t* lista);
+
+/*
+ * Devuelve un cursor sobre el último elemento de la lista, o fuera de
+ * la lista si esta vacía.
+ */
+lista_cursor_t lista_cursor_final(lista_t* lista);
+
+/*
+ * Devuelve true si el cursor esta sobre un elemento o false si esta
+ * fuera de la lista.
+ */
+bool lista_cursor_valido(lista_cursor_t* cursor);
+
+/*
+ * Devuelve el elemento sobre el que esta el cursor o NULL si esta fuera
+ * de la lista.
+ */
+void* lista_cursor_actual(lista_cursor_t* cursor);
+
+/*
+ * Devuelve la posicion del elemento sobre el que esta el cursor, o la
+ * cantidad de elementos de la lista si esta fuera de la misma.
+ */
+size_t lista_cursor_posicion(lista_cursor_t* cursor);
+
+/*
+ * Mueve el cursor al elemento siguiente. Desde el último sale de la
+ * lista y desde fuera de la lista pasa al primero.
+ * Devuelve true si quedo sobre un elemento o false en caso contrario.
+ */
+bool lista_cursor_siguiente(lista_cursor_t* cursor);
+
+/*
+ * Mueve el cursor al elemento anterior. Desde el primero sale de la
+ * lista y desde fuera de la lista pasa al último.
+ * Devuelve true si quedo sobre un elemento o false en caso contrario.
+ */
+bool lista_cursor_anterior(lista_cursor_t* cursor);
+
+/*
+ * Inserta un elemento antes del elemento actual, o al final de la lista
+ * si el cursor esta fuera de la misma. El cursor sigue sobre el mismo
+ * elemento.
+ * Devuelve 0 si pudo insertar o -1 si no pudo.
+ */
+int lista_cursor_insertar_aqui(lista_cursor_t* cursor, void* elemento);
+
+/*
+ * Quita de la lista el elemento actual y mueve el cursor al siguiente,
+ * o fuera de la lista si era el último.
+ * Devuelve 0 si pudo eliminar o -1 si no pudo.
+ */
+int lista_cursor_borrar_actual(lista_cursor_t* cursor);
+
 /*
  * Iterador interno. Recorre la lista e invoca la funcion con cada
  * elemento de la misma.
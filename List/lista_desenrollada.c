@@ -0,0 +1,458 @@
+#include "lista_desenrollada.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ELEMENTOS_POR_BLOQUE 32 // Cantidad maxima de elementos de cada bloque
+#define MINIMO_POR_BLOQUE    16 // Al borrar, un bloque con menos se junta o toma de un vecino
+
+typedef struct bloque
+{
+    void*          datos[ELEMENTOS_POR_BLOQUE];
+    size_t         cantidad;
+    struct bloque* siguiente;
+    struct bloque* anterior;
+} bloque_t;
+
+struct lista_desenrollada
+{
+    bloque_t* head;
+    bloque_t* tail;
+    size_t    largo;
+};
+
+struct lista_desenrollada_iterador
+{
+    bloque_t* actual;
+    size_t    indice;
+};
+
+lista_desenrollada_t* lista_desenrollada_crear()
+{
+    return calloc(1, sizeof(lista_desenrollada_t));
+}
+
+/*
+ * Crea un bloque vacio y lo engancha en la lista antes de siguiente, o
+ * al final si siguiente es NULL.
+ * Devuelve el bloque creado o NULL en caso de fallar.
+ */
+static bloque_t* nuevo_bloque(lista_desenrollada_t* lista, bloque_t* siguiente)
+{
+    bloque_t* bloque = calloc(1, sizeof(bloque_t));
+    if (!bloque)
+        return NULL;
+    bloque->siguiente = siguiente;
+    bloque->anterior = siguiente ? siguiente->anterior : lista->tail;
+    if (bloque->anterior)
+        bloque->anterior->siguiente = bloque;
+    else
+        lista->head = bloque;
+    if (siguiente)
+        siguiente->anterior = bloque;
+    else
+        lista->tail = bloque;
+    return bloque;
+}
+
+/*
+ * Desengancha el bloque de la lista y libera su memoria.
+ */
+static void liberar_bloque(lista_desenrollada_t* lista, bloque_t* bloque)
+{
+    if (bloque->anterior)
+        bloque->anterior->siguiente = bloque->siguiente;
+    else
+        lista->head = bloque->siguiente;
+    if (bloque->siguiente)
+        bloque->siguiente->anterior = bloque->anterior;
+    else
+        lista->tail = bloque->anterior;
+    free(bloque);
+}
+
+/*
+ * Busca el bloque que contiene la posicion indicada, que debe existir,
+ * recorriendo desde el extremo mas cercano. Deja en posicion el indice
+ * del elemento dentro del bloque.
+ */
+static bloque_t* ubicar(lista_desenrollada_t* lista, size_t* posicion)
+{
+    if (*posicion < lista->largo / 2)
+    {
+        bloque_t* bloque = lista->head;
+        while (*posicion >= bloque->cantidad)
+        {
+            *posicion -= bloque->cantidad;
+            bloque = bloque->siguiente;
+        }
+        return bloque;
+    }
+    bloque_t* bloque = lista->tail;
+    size_t    desde_el_final = lista->largo - *posicion;
+    while (desde_el_final > bloque->cantidad)
+    {
+        desde_el_final -= bloque->cantidad;
+        bloque = bloque->anterior;
+    }
+    *posicion = bloque->cantidad - desde_el_final;
+    return bloque;
+}
+
+/*
+ * Inserta el elemento en el indice dado del bloque. Si el bloque esta
+ * lleno, el elemento va a un bloque nuevo cuando se inserta en un
+ * extremo, o si no el bloque se parte a la mitad.
+ * Devuelve 0 si pudo insertar o -1 si no pudo.
+ */
+static int insertar_en_bloque(lista_desenrollada_t* lista, bloque_t* bloque, size_t indice,
+                              void* elemento)
+{
+    if (bloque->cantidad == ELEMENTOS_POR_BLOQUE)
+    {
+        bloque_t* nuevo = nuevo_bloque(lista, indice == 0 ? bloque : bloque->siguiente);
+        if (!nuevo)
+            return -1;
+        if (indice == 0 || indice == ELEMENTOS_POR_BLOQUE)
+        {
+            bloque = nuevo;
+            indice = 0;
+        }
+        else
+        {
+            size_t mitad = ELEMENTOS_POR_BLOQUE / 2;
+            memcpy(nuevo->datos, bloque->datos + mitad, mitad * sizeof(void*));
+            nuevo->cantidad = mitad;
+            bloque->cantidad = mitad;
+            if (indice > mitad)
+            {
+                bloque = nuevo;
+                indice -= mitad;
+            }
+        }
+    }
+    memmove(bloque->datos + indice + 1, bloque->datos + indice,
+            (bloque->cantidad - indice) * sizeof(void*));
+    bloque->datos[indice] = elemento;
+    bloque->cantidad++;
+    lista->largo++;
+    return 0;
+}
+
+/*
+ * Pasa todos los elementos de derecho al final de izquierdo, que deben
+ * ser vecinos y entrar en un bloque, y libera derecho.
+ */
+static void juntar(lista_desenrollada_t* lista, bloque_t* izquierdo, bloque_t* derecho)
+{
+    memcpy(izquierdo->datos + izquierdo->cantidad, derecho->datos,
+           derecho->cantidad * sizeof(void*));
+    izquierdo->cantidad += derecho->cantidad;
+    liberar_bloque(lista, derecho);
+}
+
+/*
+ * Reparte los elementos de dos bloques vecinos en partes iguales,
+ * moviendo los del borde entre ambos.
+ */
+static void equilibrar(bloque_t* izquierdo, bloque_t* derecho)
+{
+    size_t total = izquierdo->cantidad + derecho->cantidad;
+    if (izquierdo->cantidad < total / 2)
+    {
+        size_t mover = total / 2 - izquierdo->cantidad;
+        memcpy(izquierdo->datos + izquierdo->cantidad, derecho->datos, mover * sizeof(void*));
+        memmove(derecho->datos, derecho->datos + mover,
+                (derecho->cantidad - mover) * sizeof(void*));
+        izquierdo->cantidad += mover;
+        derecho->cantidad -= mover;
+    }
+    else if (derecho->cantidad < total / 2)
+    {
+        size_t mover = total / 2 - derecho->cantidad;
+        memmove(derecho->datos + mover, derecho->datos, derecho->cantidad * sizeof(void*));
+        memcpy(derecho->datos, izquierdo->datos + izquierdo->cantidad - mover,
+               mover * sizeof(void*));
+        izquierdo->cantidad -= mover;
+        derecho->cantidad += mover;
+    }
+}
+
+/*
+ * Quita el elemento en el indice dado del bloque. Si el bloque queda
+ * con menos de MINIMO_POR_BLOQUE elementos, se junta con el vecino que
+ * tenga menos si entran en un bloque, o si no le toma elementos hasta
+ * quedar parejos. Asi los bloques no quedan casi vacios al borrar.
+ */
+static void borrar_de_bloque(lista_desenrollada_t* lista, bloque_t* bloque, size_t indice)
+{
+    bloque->cantidad--;
+    memmove(bloque->datos + indice, bloque->datos + indice + 1,
+            (bloque->cantidad - indice) * sizeof(void*));
+    lista->largo--;
+    if (!bloque->cantidad)
+    {
+        liberar_bloque(lista, bloque);
+        return;
+    }
+    if (bloque->cantidad >= MINIMO_POR_BLOQUE)
+        return;
+    bloque_t* vecino = bloque->siguiente;
+    if (!vecino || (bloque->anterior && bloque->anterior->cantidad < vecino->cantidad))
+        vecino = bloque->anterior;
+    if (!vecino)
+        return;
+    bloque_t* izquierdo = vecino == bloque->anterior ? vecino : bloque;
+    bloque_t* derecho = izquierdo == bloque ? vecino : bloque;
+    if (bloque->cantidad + vecino->cantidad <= ELEMENTOS_POR_BLOQUE)
+        juntar(lista, izquierdo, derecho);
+    else
+        equilibrar(izquierdo, derecho);
+}
+
+/*
+ * Inserta un elemento al final de la lista.
+ * Devuelve 0 si pudo insertar o -1 si no pudo.
+ */
+int lista_desenrollada_insertar(lista_desenrollada_t* lista, void* elemento)
+{
+    if (!lista)
+        return -1;
+    if (!lista->tail && !nuevo_bloque(lista, NULL))
+        return -1;
+    return insertar_en_bloque(lista, lista->tail, lista->tail->cantidad, elemento);
+}
+
+/*
+ * Inserta un elemento en la posicion indicada, donde 0 es insertar
+ * como primer elemento y 1 es insertar luego del primer elemento.
+ * En caso de no existir la posicion indicada, lo inserta al final.
+ * Devuelve 0 si pudo insertar o -1 si no pudo.
+ */
+int lista_desenrollada_insertar_en_posicion(lista_desenrollada_t* lista, void* elemento,
+                                            size_t posicion)
+{
+    if (!lista)
+        return -1;
+    if (posicion >= lista->largo)
+        return lista_desenrollada_insertar(lista, elemento);
+    bloque_t* bloque = ubicar(lista, &posicion);
+    // Al principio de un bloque, si el anterior tiene lugar se agrega al final de ese
+    if (posicion == 0 && bloque->anterior &&
+        bloque->anterior->cantidad < ELEMENTOS_POR_BLOQUE)
+    {
+        bloque = bloque->anterior;
+        posicion = bloque->cantidad;
+    }
+    return insertar_en_bloque(lista, bloque, posicion, elemento);
+}
+
+/*
+ * Quita de la lista el elemento que se encuentra en la ultima posición.
+ * Devuelve 0 si pudo eliminar o -1 si no pudo.
+ */
+int lista_desenrollada_borrar(lista_desenrollada_t* lista)
+{
+    if (!lista || lista_desenrollada_vacia(lista))
+        return -1;
+    borrar_de_bloque(lista, lista->tail, lista->tail->cantidad - 1);
+    return 0;
+}
+
+/*
+ * Quita de la lista el elemento que se encuentra en la posición
+ * indicada, donde 0 es el primer elemento.
+ * En caso de no existir esa posición se intentará borrar el último
+ * elemento.
+ * Devuelve 0 si pudo eliminar o -1 si no pudo.
+ */
+int lista_desenrollada_borrar_de_posicion(lista_desenrollada_t* lista, size_t posicion)
+{
+    if (!lista || lista_desenrollada_vacia(lista))
+        return -1;
+    if (posicion >= lista->largo)
+        return lista_desenrollada_borrar(lista);
+    bloque_t* bloque = ubicar(lista, &posicion);
+    borrar_de_bloque(lista, bloque, posicion);
+    return 0;
+}
+
+/*
+ * Devuelve el elemento en la posicion indicada, donde 0 es el primer
+ * elemento.
+ *
+ * Si no existe dicha posicion devuelve NULL.
+ */
+void* lista_desenrollada_elemento_en_posicion(lista_desenrollada_t* lista, size_t posicion)
+{
+    if (!lista || posicion >= lista_desenrollada_elementos(lista))
+        return NULL;
+    bloque_t* bloque = ubicar(lista, &posicion);
+    return bloque->datos[posicion];
+}
+
+/*
+ * Devuelve el último elemento de la lista o NULL si la lista se
+ * encuentra vacía.
+ */
+void* lista_desenrollada_ultimo(lista_desenrollada_t* lista)
+{
+    if (!lista || lista_desenrollada_vacia(lista))
+        return NULL;
+    return lista->tail->datos[lista->tail->cantidad - 1];
+}
+
+/*
+ * Devuelve true si la lista está vacía o false en caso contrario.
+ */
+bool lista_desenrollada_vacia(lista_desenrollada_t* lista)
+{
+    return (lista_desenrollada_elementos(lista) == 0);
+}
+
+/*
+ * Devuelve la cantidad de elementos almacenados en la lista.
+ */
+size_t lista_desenrollada_elementos(lista_desenrollada_t* lista)
+{
+    if (lista)
+        return lista->largo;
+    return 0;
+}
+
+/*
+ * Apila un elemento.
+ * Devuelve 0 si pudo o -1 en caso contrario.
+ */
+int lista_desenrollada_apilar(lista_desenrollada_t* lista, void* elemento)
+{
+    return lista_desenrollada_insertar(lista, elemento);
+}
+
+/*
+ * Desapila un elemento.
+ * Devuelve 0 si pudo desapilar o -1 si no pudo.
+ */
+int lista_desenrollada_desapilar(lista_desenrollada_t* lista)
+{
+    return lista_desenrollada_borrar(lista);
+}
+
+/*
+ * Devuelve el elemento en el tope de la pila o NULL
+ * en caso de estar vacía.
+ */
+void* lista_desenrollada_tope(lista_desenrollada_t* lista)
+{
+    return lista_desenrollada_ultimo(lista);
+}
+
+/*
+ * Encola un elemento.
+ * Devuelve 0 si pudo encolar o -1 si no pudo.
+ */
+int lista_desenrollada_encolar(lista_desenrollada_t* lista, void* elemento)
+{
+    return lista_desenrollada_insertar_en_posicion(lista, elemento, 0);
+}
+
+/*
+ * Desencola un elemento.
+ * Devuelve 0 si pudo desencolar o -1 si no pudo.
+ */
+int lista_desenrollada_desencolar(lista_desenrollada_t* lista)
+{
+    return lista_desenrollada_borrar(lista);
+}
+
+/*
+ * Devuelve el primer elemento de la cola o NULL en caso de estar
+ * vacía.
+ */
+void* lista_desenrollada_primero(lista_desenrollada_t* lista)
+{
+    return lista_desenrollada_tope(lista);
+}
+
+/*
+ * Libera la memoria reservada por la lista.
+ */
+void lista_desenrollada_destruir(lista_desenrollada_t* lista)
+{
+    if (!lista)
+        return;
+    while (lista->head)
+        liberar_bloque(lista, lista->head);
+    free(lista);
+}
+
+/*
+ * Crea un iterador para una lista. El iterador creado es válido desde
+ * el momento de su creación hasta que no haya mas elementos por
+ * recorrer o se modifique la lista iterada (agregando o quitando
+ * elementos de la lista).
+ *
+ * Devuelve el puntero al iterador creado o NULL en caso de error.
+ */
+lista_desenrollada_iterador_t* lista_desenrollada_iterador_crear(lista_desenrollada_t* lista)
+{
+    if (!lista)
+        return NULL;
+    lista_desenrollada_iterador_t* it = calloc(1, sizeof(lista_desenrollada_iterador_t));
+    if (!it)
+        return NULL;
+    it->actual = lista->head;
+    return it;
+}
+
+/*
+ * Devuelve true si hay mas elementos sobre los cuales iterar o false
+ * si no hay mas.
+ */
+bool lista_desenrollada_iterador_tiene_siguiente(lista_desenrollada_iterador_t* iterador)
+{
+    if (!iterador)
+        return false;
+    return iterador->actual;
+}
+
+/*
+ * Devuelve el próximo elemento disponible en la iteración.
+ * En caso de error devuelve NULL.
+ */
+void* lista_desenrollada_iterador_siguiente(lista_desenrollada_iterador_t* iterador)
+{
+    if (!lista_desenrollada_iterador_tiene_siguiente(iterador))
+        return NULL;
+    void* actual = iterador->actual->datos[iterador->indice++];
+    if (iterador->indice == iterador->actual->cantidad)
+    {
+        iterador->actual = iterador->actual->siguiente;
+        iterador->indice = 0;
+    }
+    return actual;
+}
+
+/*
+ * Libera la memoria reservada por el iterador.
+ */
+void lista_desenrollada_iterador_destruir(lista_desenrollada_iterador_t* iterador)
+{
+    free(iterador);
+}
+
+/*
+ * Iterador interno. Recorre la lista e invoca la funcion con cada
+ * elemento de la misma.
+ */
+void lista_desenrollada_con_cada_elemento(lista_desenrollada_t* lista,
+                                          void (*funcion)(void*, void*), void* contexto)
+{
+    if (!lista || !funcion)
+        return;
+    for (bloque_t* bloque = lista->head; bloque; bloque = bloque->siguiente)
+        for (size_t i = 0; i < bloque->cantidad; i++)
+            funcion(bloque->datos[i], contexto);
+}
@@ -0,0 +1,151 @@
+#ifndef __LISTA_DESENROLLADA_H__
+#define __LISTA_DESENROLLADA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Lista desenrollada: misma interfaz que lista.h, pero cada nodo guarda
+ * un bloque de varios elementos contiguos en lugar de uno solo. Los
+ * recorridos secuenciales leen los elementos de a bloques y se hace una
+ * reserva de memoria cada varios elementos insertados.
+ */
+typedef struct lista_desenrollada lista_desenrollada_t;
+typedef struct lista_desenrollada_iterador lista_desenrollada_iterador_t;
+
+/*
+ * Crea la lista reservando la memoria necesaria.
+ * Devuelve un puntero a la lista creada o NULL en caso de error.
+ */
+lista_desenrollada_t* lista_desenrollada_crear();
+
+/*
+ * Inserta un elemento al final de la lista.
+ * Devuelve 0 si pudo insertar o -1 si no pudo.
+ */
+int lista_desenrollada_insertar(lista_desenrollada_t* lista, void* elemento);
+
+/*
+ * Inserta un elemento en la posicion indicada, donde 0 es insertar
+ * como primer elemento y 1 es insertar luego del primer elemento.
+ * En caso de no existir la posicion indicada, lo inserta al final.
+ * Devuelve 0 si pudo insertar o -1 si no pudo.
+ */
+int lista_desenrollada_insertar_en_posicion(lista_desenrollada_t* lista, void* elemento,
+                                            size_t posicion);
+
+/*
+ * Quita de la lista el elemento que se encuentra en la ultima posición.
+ * Devuelve 0 si pudo eliminar o -1 si no pudo.
+ */
+int lista_desenrollada_borrar(lista_desenrollada_t* lista);
+
+/*
+ * Quita de la lista el elemento que se encuentra en la posición
+ * indicada, donde 0 es el primer elemento.
+ * En caso de no existir esa posición se intentará borrar el último
+ * elemento.
+ * Devuelve 0 si pudo eliminar o -1 si no pudo.
+ */
+int lista_desenrollada_borrar_de_posicion(lista_desenrollada_t* lista, size_t posicion);
+
+/*
+ * Devuelve el elemento en la posicion indicada, donde 0 es el primer
+ * elemento.
+ *
+ * Si no existe dicha posicion devuelve NULL.
+ */
+void* lista_desenrollada_elemento_en_posicion(lista_desenrollada_t* lista, size_t posicion);
+
+/*
+ * Devuelve el último elemento de la lista o NULL si la lista se
+ * encuentra vacía.
+ */
+void* lista_desenrollada_ultimo(lista_desenrollada_t* lista);
+
+/*
+ * Devuelve true si la lista está vacía o false en caso contrario.
+ */
+bool lista_desenrollada_vacia(lista_desenrollada_t* lista);
+
+/*
+ * Devuelve la cantidad de elementos almacenados en la lista.
+ */
+size_t lista_desenrollada_elementos(lista_desenrollada_t* lista);
+
+/*
+ * Apila un elemento.
+ * Devuelve 0 si pudo o -1 en caso contrario.
+ */
+int lista_desenrollada_apilar(lista_desenrollada_t* lista, void* elemento);
+
+/*
+ * Desapila un elemento.
+ * Devuelve 0 si pudo desapilar o -1 si no pudo.
+ */
+int lista_desenrollada_desapilar(lista_desenrollada_t* lista);
+
+/*
+ * Devuelve el elemento en el tope de la pila o NULL
+ * en caso de estar vacía.
+ */
+void* lista_desenrollada_tope(lista_desenrollada_t* lista);
+
+/*
+ * Encola un elemento.
+ * Devuelve 0 si pudo encolar o -1 si no pudo.
+ */
+int lista_desenrollada_encolar(lista_desenrollada_t* lista, void* elemento);
+
+/*
+ * Desencola un elemento.
+ * Devuelve 0 si pudo desencolar o -1 si no pudo.
+ */
+int lista_desenrollada_desencolar(lista_desenrollada_t* lista);
+
+/*
+ * Devuelve el primer elemento de la cola o NULL en caso de estar
+ * vacía.
+ */
+void* lista_desenrollada_primero(lista_desenrollada_t* lista);
+
+/*
+ * Libera la memoria reservada por la lista.
+ */
+void lista_desenrollada_destruir(lista_desenrollada_t* lista);
+
+/*
+ * Crea un iterador para una lista. El iterador creado es válido desde
+ * el momento de su creación hasta que no haya mas elementos por
+ * recorrer o se modifique la lista iterada (agregando o quitando
+ * elementos de la lista).
+ *
+ * Devuelve el puntero al iterador creado o NULL en caso de error.
+ */
+lista_desenrollada_iterador_t* lista_desenrollada_iterador_crear(lista_desenrollada_t* lista);
+
+/*
+ * Devuelve true si hay mas elementos sobre los cuales iterar o false
+ * si no hay mas.
+ */
+bool lista_desenrollada_iterador_tiene_siguiente(lista_desenrollada_iterador_t* iterador);
+
+/*
+ * Devuelve el próximo elemento disponible en la iteración.
+ * En caso de error devuelve NULL.
+ */
+void* lista_desenrollada_iterador_siguiente(lista_desenrollada_iterador_t* iterador);
+
+/*
+ * Libera la memoria reservada por el iterador.
+ */
+void lista_desenrollada_iterador_destruir(lista_desenrollada_iterador_t* iterador);
+
+/*
+ * Iterador interno. Recorre la lista e invoca la funcion con cada
+ * elemento de la misma.
+ */
+void lista_desenrollada_con_cada_elemento(lista_desenrollada_t* lista,
+                                          void (*funcion)(void*, void*), void* contexto);
+
+#endif /* __LISTA_DESENROLLADA_H__ */
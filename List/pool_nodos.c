@@ -0,0 +1,199 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pool_nodos.h"
+
+#define NODOS_PRIMER_BLOQUE 32   // Cantidad de nodos del primer bloque
+#define NODOS_MAXIMO_BLOQUE 4096 // Los bloques crecen al doble hasta este limite
+
+typedef struct bloque
+{
+    struct bloque* siguiente;
+    size_t         capacidad;
+    max_align_t    nodos[]; // Alineado para cualquier tipo de nodo
+} bloque_t;
+
+typedef struct libre
+{
+    struct libre* siguiente;
+} libre_t;
+
+struct pool_nodos
+{
+    size_t    tamanio_nodo;
+    bloque_t* bloques; // El primer bloque es el que se esta llenando
+    bloque_t* ultimo_bloque;
+    size_t    usados; // Nodos entregados del primer bloque
+    libre_t*  libres;
+    libre_t*  ultimo_libre;
+    size_t    usuarios;
+};
+
+/*
+ * Crea un pool que entrega nodos del tamaño indicado (en bytes).
+ *
+ * Devuelve un puntero al pool creado o NULL en caso de error.
+ */
+pool_nodos_t* pool_crear(size_t tamanio_nodo)
+{
+    if (!tamanio_nodo)
+        return NULL;
+    pool_nodos_t* pool = calloc(1, sizeof(pool_nodos_t));
+    if (!pool)
+        return NULL;
+    // Cada nodo tiene que poder guardar el enlace de la lista de libres y mantener la alineacion
+    if (tamanio_nodo < sizeof(libre_t))
+        tamanio_nodo = sizeof(libre_t);
+    size_t alineacion = _Alignof(max_align_t);
+    pool->tamanio_nodo = (tamanio_nodo + alineacion - 1) / alineacion * alineacion;
+    pool->usuarios = 1;
+    return pool;
+}
+
+/*
+ * Agrega un bloque nuevo al pool, del doble de capacidad que el anterior.
+ *
+ * Devuelve el bloque agregado o NULL en caso de error.
+ */
+static bloque_t* agregar_bloque(pool_nodos_t* pool)
+{
+    size_t capacidad = NODOS_PRIMER_BLOQUE;
+    if (pool->bloques)
+        capacidad = pool->bloques->capacidad * 2;
+    if (capacidad > NODOS_MAXIMO_BLOQUE)
+        capacidad = NODOS_MAXIMO_BLOQUE;
+    bloque_t* bloque = malloc(sizeof(bloque_t) + capacidad * pool->tamanio_nodo);
+    if (!bloque)
+        return NULL;
+    bloque->capacidad = capacidad;
+    bloque->siguiente = pool->bloques;
+    if (!pool->bloques)
+        pool->ultimo_bloque = bloque;
+    pool->bloques = bloque;
+    pool->usados = 0;
+    return bloque;
+}
+
+/*
+ * Devuelve un nodo del pool con toda su memoria en 0, o NULL en caso
+ * de no poder reservar memoria.
+ */
+void* pool_reservar(pool_nodos_t* pool)
+{
+    if (!pool)
+        return NULL;
+    void* nodo = NULL;
+    if (pool->libres)
+    {
+        nodo = pool->libres;
+        pool->libres = pool->libres->siguiente;
+        if (!pool->libres)
+            pool->ultimo_libre = NULL;
+    }
+    else
+    {
+        if (!pool->bloques || pool->usados == pool->bloques->capacidad)
+            if (!agregar_bloque(pool))
+                return NULL;
+        nodo = (char*)pool->bloques->nodos + pool->usados * pool->tamanio_nodo;
+        pool->usados++;
+    }
+    memset(nodo, 0, pool->tamanio_nodo);
+    return nodo;
+}
+
+/*
+ * Devuelve el nodo al pool para que pueda ser reutilizado.
+ * El nodo debe haber sido reservado con el mismo pool.
+ */
+void pool_liberar(pool_nodos_t* pool, void* nodo)
+{
+    if (!pool || !nodo)
+        return;
+    libre_t* libre = nodo;
+    libre->siguiente = pool->libres;
+    if (!pool->libres)
+        pool->ultimo_libre = libre;
+    pool->libres = libre;
+}
+
+/*
+ * Agrega un usuario al pool, que debera llamar a pool_destruir cuando
+ * deje de usarlo. Los bloques se liberan cuando lo destruye el ultimo.
+ *
+ * Devuelve el mismo pool.
+ */
+pool_nodos_t* pool_compartir(pool_nodos_t* pool)
+{
+    if (pool)
+        pool->usuarios++;
+    return pool;
+}
+
+/*
+ * Devuelve true si el pool tiene mas de un usuario.
+ */
+bool pool_es_compartido(pool_nodos_t* pool)
+{
+    return pool && pool->usuarios > 1;
+}
+
+/*
+ * Mueve todos los bloques y nodos libres de origen a destino, en O(1),
+ * y destruye origen. Los nodos reservados de origen pasan a pertenecer
+ * a destino. Solo es posible si ambos pools tienen el mismo tamaño de
+ * nodo y origen no es compartido.
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso nada cambia.
+ */
+int pool_absorber(pool_nodos_t* destino, pool_nodos_t* origen)
+{
+    if (!destino || !origen || destino == origen)
+        return -1;
+    if (destino->tamanio_nodo != origen->tamanio_nodo || pool_es_compartido(origen))
+        return -1;
+    // Los bloques de origen van al final, asi el primer bloque de destino sigue llenandose.
+    // Lo que quedaba sin usar del primer bloque de origen se pierde hasta destruir el pool.
+    if (origen->bloques)
+    {
+        if (destino->bloques)
+        {
+            destino->ultimo_bloque->siguiente = origen->bloques;
+            destino->ultimo_bloque = origen->ultimo_bloque;
+        }
+        else
+        {
+            destino->bloques = origen->bloques;
+            destino->ultimo_bloque = origen->ultimo_bloque;
+            destino->usados = origen->usados;
+        }
+    }
+    if (origen->libres)
+    {
+        origen->ultimo_libre->siguiente = destino->libres;
+        if (!destino->libres)
+            destino->ultimo_libre = origen->ultimo_libre;
+        destino->libres = origen->libres;
+    }
+    free(origen);
+    return 0;
+}
+
+/*
+ * Deja de usar el pool. Cuando lo deja de usar el ultimo usuario, se
+ * liberan todos los bloques de una vez, junto con todos los nodos que
+ * se hayan reservado del mismo.
+ */
+void pool_destruir(pool_nodos_t* pool)
+{
+    if (!pool || --pool->usuarios > 0)
+        return;
+    while (pool->bloques)
+    {
+        bloque_t* siguiente = pool->bloques->siguiente;
+        free(pool->bloques);
+        pool->bloques = siguiente;
+    }
+    free(pool);
+}
@@ -0,0 +1,66 @@
+#ifndef __POOL_NODOS_H__
+#define __POOL_NODOS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Pool de nodos de tamaño fijo. Reserva la memoria en bloques grandes
+ * (slabs) y reutiliza los nodos liberados mediante una lista de libres
+ * interna, evitando pasar por malloc/free en cada alta o baja.
+ *
+ * BST y List se compilan por separado y cada uno tiene su copia de
+ * pool_nodos.h y pool_nodos.c: las dos copias deben ser identicas, y
+ * cualquier cambio se aplica en ambas.
+ */
+typedef struct pool_nodos pool_nodos_t;
+
+/*
+ * Crea un pool que entrega nodos del tamaño indicado (en bytes).
+ *
+ * Devuelve un puntero al pool creado o NULL en caso de error.
+ */
+pool_nodos_t* pool_crear(size_t tamanio_nodo);
+
+/*
+ * Devuelve un nodo del pool con toda su memoria en 0, o NULL en caso
+ * de no poder reservar memoria.
+ */
+void* pool_reservar(pool_nodos_t* pool);
+
+/*
+ * Devuelve el nodo al pool para que pueda ser reutilizado.
+ * El nodo debe haber sido reservado con el mismo pool.
+ */
+void pool_liberar(pool_nodos_t* pool, void* nodo);
+
+/*
+ * Agrega un usuario al pool, que debera llamar a pool_destruir cuando
+ * deje de usarlo. Los bloques se liberan cuando lo destruye el ultimo.
+ *
+ * Devuelve el mismo pool.
+ */
+pool_nodos_t* pool_compartir(pool_nodos_t* pool);
+
+/*
+ * Devuelve true si el pool tiene mas de un usuario.
+ */
+bool pool_es_compartido(pool_nodos_t* pool);
+
+/*
+ * Mueve todos los bloques y nodos libres de origen a destino, en O(1),
+ * y destruye origen. Los nodos reservados de origen pasan a pertenecer
+ * a destino. Solo es posible si ambos pools tienen el mismo tamaño de
+ * nodo y origen no es compartido.
+ * Devuelve 0 si pudo o -1 si no pudo, en cuyo caso nada cambia.
+ */
+int pool_absorber(pool_nodos_t* destino, pool_nodos_t* origen);
+
+/*
+ * Deja de usar el pool. Cuando lo deja de usar el ultimo usuario, se
+ * liberan todos los bloques de una vez, junto con todos los nodos que
+ * se hayan reservado del mismo.
+ */
+void pool_destruir(pool_nodos_t* pool);
+
+#endif /* __POOL_NODOS_H__ */